@@ -28,6 +28,15 @@
 #include "tiny_obj_loader.h"
 
 #if defined(__EMSCRIPTEN__)
+namespace {
+// Resumes the main loop paused by on-demand rendering when a new event is
+// pushed to the SDL event queue
+int resumeMainLoopWatcher(void *data, [[maybe_unused]] SDL_Event *event) {
+  static_cast<abcg::Window *>(data)->requestRepaint();
+  return 0;
+}
+} // namespace
+
 void abcg::mainLoopCallback(void *userData) {
   abcg::Application &app{*(static_cast<abcg::Application *>(userData))};
   bool done{};
@@ -75,8 +84,41 @@ abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
  * @throw abcg::SDLImageError if `IMG_Init` failed.
  */
 void abcg::Application::run(Window &window) {
-  if (Uint32 const subsystemMask{SDL_INIT_VIDEO | SDL_INIT_AUDIO |
-                                 SDL_INIT_GAMECONTROLLER};
+  create(window);
+
+#if defined(__EMSCRIPTEN__)
+  SDL_AddEventWatch(resumeMainLoopWatcher, m_window);
+  emscripten_set_main_loop_arg(mainLoopCallback, this, 0, true);
+#else
+  auto done{false};
+  while (!done) {
+    mainLoopIterator(done);
+  }
+#endif
+
+  destroy();
+}
+
+/**
+ * @brief Initializes the SDL library and creates the given window without
+ * entering the event loop.
+ *
+ * Use this together with abcg::Application::paintFrame and
+ * abcg::Application::destroy to drive the application loop programmatically,
+ * e.g., for rendering a batch of images in headless mode (see
+ * abcg::OpenGLSettings::headless). In headless mode, only the SDL core is
+ * initialized and no display is required.
+ *
+ * @param window L-value reference to the window object.
+ *
+ * @throw abcg::SDLError if `SDL_Init` failed.
+ * @throw abcg::SDLImageError if `IMG_Init` failed.
+ */
+void abcg::Application::create(Window &window) {
+  if (Uint32 const subsystemMask{window.isHeadless()
+                                     ? 0U
+                                     : SDL_INIT_VIDEO | SDL_INIT_AUDIO |
+                                           SDL_INIT_GAMECONTROLLER};
       SDL_Init(subsystemMask) != 0) {
     throw abcg::SDLError("SDL_Init failed");
   }
@@ -92,17 +134,41 @@ void abcg::Application::run(Window &window) {
 
   m_window = &window;
   m_window->templateCreate();
+}
 
-#if defined(__EMSCRIPTEN__)
-  emscripten_set_main_loop_arg(mainLoopCallback, this, 0, true);
-#else
+/**
+ * @brief Processes the pending events and paints one frame.
+ *
+ * The frame is painted even if on-demand rendering is enabled and nothing
+ * changed, and the frame rate is not limited.
+ *
+ * @returns `false` if the window was closed; `true` otherwise.
+ *
+ * @sa abcg::Application::create.
+ */
+bool abcg::Application::paintFrame() {
   auto done{false};
-  while (!done) {
-    mainLoopIterator(done);
+  SDL_Event event{};
+  while (SDL_PollEvent(&event) != 0) {
+    if (event.type == SDL_QUIT)
+      done = true;
+    m_window->templateHandleEvent(event, done);
   }
-#endif
+  m_window->templatePaint();
+  return !done;
+}
+
+/**
+ * @brief Destroys the window and shuts down the SDL library.
+ *
+ * @sa abcg::Application::create.
+ */
+void abcg::Application::destroy() {
+  if (m_window == nullptr)
+    return;
 
   m_window->templateDestroy();
+  m_window = nullptr;
 
 #if !defined(__EMSCRIPTEN__)
   IMG_Quit();
@@ -145,14 +211,60 @@ std::string const &abcg::Application::getBasePath() noexcept {
   return m_basePath;
 }
 
-void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) const {
-  SDL_Event event{};
-  while (SDL_PollEvent(&event) != 0) {
+void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) {
+  auto const handleEvent{[&](SDL_Event const &event) {
 #if !defined(__EMSCRIPTEN__)
     if (event.type == SDL_QUIT)
       done = true;
 #endif
     m_window->templateHandleEvent(event, done);
+  }};
+
+  SDL_Event event{};
+#if !defined(__EMSCRIPTEN__)
+  // With on-demand rendering, block until an event arrives instead of
+  // repainting a frame that did not change
+  if (!m_window->isRepaintNeeded()) {
+    m_window->m_idle = true;
+    m_window->m_frameLimiter.reset();
+    if (SDL_WaitEventTimeout(
+            &event, m_window->getWindowSettings().eventWaitTimeout) == 0) {
+      return;
+    }
+    handleEvent(event);
   }
-  m_window->templatePaint();
+#endif
+
+  while (SDL_PollEvent(&event) != 0) {
+    handleEvent(event);
+  }
+
+  if (m_window->isRepaintNeeded()) {
+    m_window->templatePaint();
+#if !defined(__EMSCRIPTEN__)
+    m_window->m_frameLimiter.wait(
+        m_window->getWindowSettings().targetFrameRate);
+#endif
+  }
+
+#if defined(__EMSCRIPTEN__)
+  // Frames are scheduled by the browser: requestAnimationFrame when there is
+  // no target frame rate, setTimeout otherwise
+  if (auto const frameRate{m_window->getWindowSettings().targetFrameRate};
+      frameRate != m_mainLoopFrameRate) {
+    if (frameRate > 0) {
+      emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, 1000 / frameRate);
+    } else {
+      emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+    }
+    m_mainLoopFrameRate = frameRate;
+  }
+
+  // The browser cannot block waiting for events. Pause the main loop instead;
+  // it is resumed by resumeMainLoopWatcher or abcg::Window::requestRepaint
+  if (!m_window->isRepaintNeeded()) {
+    m_window->m_idle = true;
+    emscripten_pause_main_loop();
+  }
+#endif
 }
@@ -40,13 +40,20 @@ public:
 
   void run(Window &window);
 
+  void create(Window &window);
+  bool paintFrame();
+  void destroy();
+
   static std::string const &getAssetsPath() noexcept;
   static std::string const &getBasePath() noexcept;
 
 private:
-  void mainLoopIterator(bool &done) const;
+  void mainLoopIterator(bool &done);
 
   Window *m_window{};
+#if defined(__EMSCRIPTEN__)
+  int m_mainLoopFrameRate{};
+#endif
 
 #if defined(__EMSCRIPTEN__)
   friend void mainLoopCallback(void *userData);
@@ -0,0 +1,113 @@
+/**
+ * @file abcgFrameLimiter.cpp
+ * @brief Definition of abcg::FrameLimiter members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFrameLimiter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std::chrono;
+
+/**
+ * @brief Blocks until the start time of the next frame.
+ *
+ * Call this once per frame, after the frame is rendered. If the previous frame
+ * took longer than the frame interval, the schedule is shifted instead of
+ * rendering the late frames in a burst.
+ *
+ * @param targetFrameRate Target frame rate, in frames per second. The call
+ * returns immediately if this is zero or negative.
+ */
+void abcg::FrameLimiter::wait(int targetFrameRate) {
+  if (targetFrameRate <= 0) {
+    reset();
+    return;
+  }
+
+  auto const period{duration_cast<clock::duration>(
+      duration<double>{1.0 / targetFrameRate})};
+  auto now{clock::now()};
+  if (!m_scheduled) {
+    m_deadline = now;
+    m_scheduled = true;
+  }
+  m_deadline += period;
+
+  if (now > m_deadline) {
+    // Missed the deadline: start the next interval from now
+    recordError(duration<double>{now - m_deadline}.count());
+    m_deadline = now;
+    return;
+  }
+
+  // Sleep while the remaining time exceeds the expected duration of a sleep
+  // plus one standard deviation
+  for (;;) {
+    auto const margin{
+        duration<double>{m_sleepMean + std::sqrt(m_sleepVariance)}};
+    if (m_deadline - now <= margin) {
+      break;
+    }
+    std::this_thread::sleep_for(milliseconds{1});
+    auto const awake{clock::now()};
+    recordSleep(duration<double>{awake - now}.count());
+    now = awake;
+  }
+
+  // Spin-wait for the rest of the interval
+  while (now < m_deadline) {
+    std::this_thread::yield();
+    now = clock::now();
+  }
+
+  recordError(duration<double>{now - m_deadline}.count());
+}
+
+/**
+ * @brief Discards the current schedule.
+ *
+ * The next call to abcg::FrameLimiter::wait starts a new schedule. Call this
+ * after the application loop has been idle, so that the idle time is not
+ * measured as pacing error.
+ */
+void abcg::FrameLimiter::reset() { m_scheduled = false; }
+
+/**
+ * @brief Returns the pacing error measured over the last frames.
+ *
+ * @returns Reference to the statistics of the last 120 frames.
+ */
+abcg::FramePacingStats const &abcg::FrameLimiter::getStats() const noexcept {
+  return m_stats;
+}
+
+void abcg::FrameLimiter::recordError(double error) {
+  m_errors.at(m_errorOffset) = error;
+  m_errorOffset = (m_errorOffset + 1) % m_errors.size();
+  m_errorCount = std::min(m_errorCount + 1, m_errors.size());
+
+  auto const first{m_errors.begin()};
+  auto const last{first + static_cast<std::ptrdiff_t>(m_errorCount)};
+  auto sum{0.0};
+  std::for_each(first, last, [&](double value) { sum += value; });
+  m_stats.meanError = sum / static_cast<double>(m_errorCount);
+  m_stats.maxError = *std::max_element(first, last);
+}
+
+void abcg::FrameLimiter::recordSleep(double duration) {
+  // Plain average for the first samples, then an exponential moving average
+  // that follows changes in the system load
+  m_sleepCount = std::min(m_sleepCount + 1, 64);
+  auto const weight{1.0 / m_sleepCount};
+  auto const delta{duration - m_sleepMean};
+  m_sleepMean += weight * delta;
+  m_sleepVariance = (1.0 - weight) * (m_sleepVariance + weight * delta * delta);
+}
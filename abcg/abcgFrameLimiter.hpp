@@ -0,0 +1,72 @@
+/**
+ * @file abcgFrameLimiter.hpp
+ * @brief Header file of abcg::FrameLimiter.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAME_LIMITER_HPP_
+#define ABCG_FRAME_LIMITER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace abcg {
+struct FramePacingStats;
+class FrameLimiter;
+} // namespace abcg
+
+/**
+ * @brief Frame pacing statistics measured by abcg::FrameLimiter.
+ *
+ * The pacing error of a frame is the time between its scheduled start and the
+ * time the frame limiter actually released it.
+ */
+struct abcg::FramePacingStats {
+  /** @brief Mean pacing error over the last frames, in seconds. */
+  double meanError{};
+  /** @brief Maximum pacing error over the last frames, in seconds. */
+  double maxError{};
+};
+
+/**
+ * @brief Caps the frame rate of the application loop.
+ *
+ * Frames are scheduled at fixed intervals on `std::chrono::steady_clock`. The
+ * limiter sleeps while the next deadline is farther than the measured sleep
+ * overshoot of the operating system and spin-waits for the remaining time,
+ * which keeps the jitter low without busy-waiting for the whole interval.
+ */
+class abcg::FrameLimiter {
+public:
+  void wait(int targetFrameRate);
+  void reset();
+
+  [[nodiscard]] FramePacingStats const &getStats() const noexcept;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  void recordError(double error);
+  void recordSleep(double duration);
+
+  clock::time_point m_deadline{clock::now()};
+  bool m_scheduled{false};
+
+  // Estimated duration of a 1 ms sleep (exponentially weighted mean and
+  // variance)
+  double m_sleepMean{1e-3};
+  double m_sleepVariance{};
+  int m_sleepCount{};
+
+  std::array<double, 120> m_errors{};
+  std::size_t m_errorCount{};
+  std::size_t m_errorOffset{};
+  FramePacingStats m_stats;
+};
+
+#endif
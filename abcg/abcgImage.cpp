@@ -99,4 +99,47 @@ void abcg::flipVertically(SDL_Surface &surface) {
   }
 
   SDL_UnlockSurface(&surface);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Saves pixels read from an OpenGL framebuffer to a PNG file.
+ *
+ * The rows are flipped so that the first row of the file is the top row of
+ * the image.
+ *
+ * @param filename Name of the PNG file.
+ * @param pixels Tightly packed RGBA pixels, 8 bits per channel, with rows
+ * ordered from bottom to top as returned by `glReadPixels`.
+ * @param width Image width, in pixels.
+ * @param height Image height, in pixels.
+ *
+ * @returns `true` on success; `false` on failure.
+ */
+bool abcg::savePNGFromFramebuffer(std::string const &filename,
+                                  std::span<unsigned char const> pixels,
+                                  int width, int height) {
+  auto const bitsPerPixel{8};
+  auto const channels{4};
+  auto const pitch{gsl::narrow<std::size_t>(width * channels)};
+  auto const rows{gsl::narrow<std::size_t>(height)};
+  if (pixels.size() < pitch * rows)
+    return false;
+
+  // Flip upside down while copying
+  std::vector<unsigned char> image(pitch * rows);
+  for (auto const row : iter::range(rows)) {
+    auto const source{pixels.subspan((rows - row - 1) * pitch, pitch)};
+    std::copy(source.begin(), source.end(),
+              image.begin() + gsl::narrow<long>(row * pitch));
+  }
+
+  auto *const surface{SDL_CreateRGBSurfaceFrom(
+      image.data(), width, height, channels * bitsPerPixel,
+      gsl::narrow<int>(pitch), 0x000000FF, 0x0000FF00, 0x00FF0000,
+      0xFF000000)};
+  if (surface == nullptr)
+    return false;
+  auto const saved{IMG_SavePNG(surface, filename.c_str()) == 0};
+  SDL_FreeSurface(surface);
+  return saved;
+}
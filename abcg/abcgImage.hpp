@@ -13,9 +13,15 @@
 
 #include <SDL_image.h>
 
+#include <span>
+#include <string>
+
 namespace abcg {
 void flipHorizontally(SDL_Surface &surface);
 void flipVertically(SDL_Surface &surface);
+bool savePNGFromFramebuffer(std::string const &filename,
+                            std::span<unsigned char const> pixels, int width,
+                            int height);
 } // namespace abcg
 
 #endif
@@ -15,6 +15,7 @@
 
 #include "abcg.hpp"
 #include "abcgOpenGLImage.hpp"
+#include "abcgOpenGLPoster.hpp"
 #include "abcgOpenGLShader.hpp"
 #include "abcgOpenGLWindow.hpp"
 
@@ -0,0 +1,229 @@
+/**
+ * @file abcgOpenGLCapture.cpp
+ * @brief Definition of abcg::OpenGLCaptureSession members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLCapture.hpp"
+
+#include <algorithm>
+
+#include "abcgException.hpp"
+#include "abcgImage.hpp"
+
+/**
+ * @brief Starts a new capture session.
+ *
+ * Stops the current session, if any, opens the output and creates the queue
+ * of pixel pack buffers. This must be called with the OpenGL context current.
+ *
+ * @param settings Configuration settings of the session.
+ *
+ * @throw abcg::RuntimeError if the output file cannot be opened.
+ */
+void abcg::OpenGLCaptureSession::start(CaptureSettings const &settings) {
+  stop();
+
+  m_settings = settings;
+  m_settings.frameRate = std::max(m_settings.frameRate, 1);
+  m_settings.queueSize = std::max(m_settings.queueSize, 1);
+  m_frameSize = {};
+  m_capturedFrames = 0;
+  m_droppedFrames = 0;
+  m_writtenFrames = 0;
+  m_writeError = false;
+
+  if (m_settings.format != CaptureFormat::PNGSequence) {
+    m_file.open(m_settings.path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+      throw abcg::RuntimeError(
+          fmt::format("Failed to open capture file {}", m_settings.path));
+    }
+  }
+
+  m_reader.create(m_settings.queueSize);
+  m_active = true;
+}
+
+/**
+ * @brief Stops the capture session.
+ *
+ * Blocks until the frames in the queue are written, then closes the output.
+ * This must be called with the OpenGL context current.
+ */
+void abcg::OpenGLCaptureSession::stop() {
+  if (!m_active)
+    return;
+
+  m_reader.destroy();
+  if (m_file.is_open()) {
+    m_file.close();
+  }
+  m_active = false;
+}
+
+/**
+ * @brief Captures the current read buffer.
+ *
+ * Call this once per frame, after rendering and before swapping the buffers,
+ * with the read buffer (see `glReadBuffer`) set to the rendered frame. The
+ * frame is dropped if the queue is full or if its size differs from the size
+ * of the first frame.
+ *
+ * @param size Size of the frame, in pixels.
+ */
+void abcg::OpenGLCaptureSession::captureFrame(glm::ivec2 size) {
+  if (!m_active)
+    return;
+
+  if (m_capturedFrames == 0 && m_droppedFrames == 0) {
+    m_frameSize = size;
+  }
+
+  if (size != m_frameSize ||
+      !m_reader.tryRead(
+          size, [this, frameIndex = m_capturedFrames](
+                    std::span<unsigned char const> pixels,
+                    glm::ivec2 frameSize) {
+            writeFrame(pixels, frameSize, frameIndex);
+          })) {
+    ++m_droppedFrames;
+    return;
+  }
+  ++m_capturedFrames;
+}
+
+/**
+ * @brief Hands the frames already read to the writer thread.
+ *
+ * Call this once per frame. It never blocks.
+ */
+void abcg::OpenGLCaptureSession::update() {
+  if (m_active) {
+    m_reader.update();
+  }
+}
+
+/**
+ * @brief Returns whether a capture session is active.
+ *
+ * @returns `true` between calls to abcg::OpenGLCaptureSession::start and
+ * abcg::OpenGLCaptureSession::stop; `false` otherwise.
+ */
+bool abcg::OpenGLCaptureSession::isActive() const noexcept { return m_active; }
+
+/**
+ * @brief Returns the statistics of the current or last capture session.
+ *
+ * @returns Frame counters and queue depth.
+ */
+abcg::CaptureStats abcg::OpenGLCaptureSession::getStats() const noexcept {
+  return {.capturedFrames = m_capturedFrames,
+          .writtenFrames = m_writtenFrames.load(std::memory_order_relaxed),
+          .droppedFrames = m_droppedFrames,
+          .queueDepth = m_reader.getPendingCount(),
+          .queueSize = m_reader.getBufferCount(),
+          .writeError = m_writeError.load(std::memory_order_relaxed)};
+}
+
+void abcg::OpenGLCaptureSession::writeFrame(
+    std::span<unsigned char const> pixels, glm::ivec2 size, int frameIndex) {
+  if (m_writeError)
+    return;
+
+  auto const pitch{gsl::narrow<std::size_t>(size.x) * 4};
+  auto const rows{gsl::narrow<std::size_t>(size.y)};
+
+  switch (m_settings.format) {
+  case CaptureFormat::RawRGBA:
+    // Rows are stored from bottom to top; write them from top to bottom
+    for (auto const row : iter::range(rows)) {
+      auto const source{pixels.subspan((rows - row - 1) * pitch, pitch)};
+      m_file.write(reinterpret_cast<char const *>(source.data()),
+                   gsl::narrow<std::streamsize>(pitch));
+    }
+    break;
+  case CaptureFormat::Y4M:
+    if (frameIndex == 0) {
+      m_file << fmt::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg\n",
+                            size.x, size.y, m_settings.frameRate);
+    }
+    writeY4MFrame(pixels, size);
+    break;
+  case CaptureFormat::PNGSequence:
+    if (!savePNGFromFramebuffer(
+            fmt::format("{}{:06}.png", m_settings.path, frameIndex), pixels,
+            size.x, size.y)) {
+      m_writeError = true;
+      return;
+    }
+    break;
+  }
+
+  if (m_file.is_open() && !m_file) {
+    m_writeError = true;
+    return;
+  }
+  ++m_writtenFrames;
+}
+
+void abcg::OpenGLCaptureSession::writeY4MFrame(
+    std::span<unsigned char const> pixels, glm::ivec2 size) {
+  auto const width{gsl::narrow<std::size_t>(size.x)};
+  auto const height{gsl::narrow<std::size_t>(size.y)};
+  auto const chromaWidth{(width + 1) / 2};
+  auto const chromaHeight{(height + 1) / 2};
+  m_planes.resize(width * height + 2 * chromaWidth * chromaHeight);
+
+  std::span const planes{m_planes};
+  auto const lumaPlane{planes.first(width * height)};
+  auto const uPlane{planes.subspan(width * height, chromaWidth * chromaHeight)};
+  auto const vPlane{planes.last(chromaWidth * chromaHeight)};
+
+  // Pixel (x, y), with y = 0 at the top of the image
+  auto const pixel{[&](std::size_t x, std::size_t y) {
+    return pixels.subspan(((height - y - 1) * width + x) * 4, 3);
+  }};
+
+  // BT.601 limited range, in 8-bit fixed point
+  for (auto const y : iter::range(height)) {
+    for (auto const x : iter::range(width)) {
+      auto const rgb{pixel(x, y)};
+      lumaPlane[y * width + x] = gsl::narrow_cast<unsigned char>(
+          ((66 * rgb[0] + 129 * rgb[1] + 25 * rgb[2] + 128) >> 8) + 16);
+    }
+  }
+
+  // Chroma from the average of each 2x2 block
+  for (auto const cy : iter::range(chromaHeight)) {
+    for (auto const cx : iter::range(chromaWidth)) {
+      std::array<int, 3> sum{};
+      auto count{0};
+      for (auto const y : iter::range(2 * cy, std::min(2 * cy + 2, height))) {
+        for (auto const x : iter::range(2 * cx, std::min(2 * cx + 2, width))) {
+          auto const rgb{pixel(x, y)};
+          for (auto const channel : iter::range(3)) {
+            sum.at(channel) += rgb[channel];
+          }
+          ++count;
+        }
+      }
+      auto const red{sum[0] / count};
+      auto const green{sum[1] / count};
+      auto const blue{sum[2] / count};
+      auto const index{cy * chromaWidth + cx};
+      uPlane[index] = gsl::narrow_cast<unsigned char>(
+          ((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+      vPlane[index] = gsl::narrow_cast<unsigned char>(
+          ((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+  }
+
+  m_file << "FRAME\n";
+  m_file.write(reinterpret_cast<char const *>(m_planes.data()),
+               gsl::narrow<std::streamsize>(m_planes.size()));
+}
@@ -0,0 +1,138 @@
+/**
+ * @file abcgOpenGLCapture.hpp
+ * @brief Header file of abcg::OpenGLCaptureSession and related types.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_CAPTURE_HPP_
+#define ABCG_OPENGL_CAPTURE_HPP_
+
+#include <atomic>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLPixelReader.hpp"
+
+namespace abcg {
+enum class CaptureFormat;
+struct CaptureSettings;
+struct CaptureStats;
+class OpenGLCaptureSession;
+} // namespace abcg
+
+/**
+ * @brief Output formats of a capture session.
+ *
+ * @sa abcg::CaptureSettings.
+ */
+enum class abcg::CaptureFormat {
+  /** @brief Raw frames written back to back to a single file.
+   *
+   * Each frame is width x height RGBA pixels, 8 bits per channel, with rows
+   * ordered from top to bottom.
+   */
+  RawRGBA,
+  /** @brief YUV4MPEG2 stream (4:2:0, BT.601 limited range).
+   *
+   * Can be read directly by most video encoders, e.g., `ffmpeg -i out.y4m
+   * out.mp4`.
+   */
+  Y4M,
+  /** @brief Numbered PNG files.
+   *
+   * The frame number, with 6 digits, and the `.png` extension are appended
+   * to abcg::CaptureSettings::path.
+   */
+  PNGSequence
+};
+
+/**
+ * @brief Configuration settings of a capture session.
+ *
+ * @sa abcg::OpenGLWindow::startCapture.
+ */
+struct abcg::CaptureSettings {
+  /** @brief Output format. */
+  CaptureFormat format{CaptureFormat::Y4M};
+  /** @brief Output file name, or file name prefix of a PNG sequence. */
+  std::string path{"capture.y4m"};
+  /** @brief Frame rate stored in the Y4M header, in frames per second. */
+  int frameRate{60};
+  /** @brief Maximum number of frames in flight between the render thread and
+   * the writer thread.
+   *
+   * When the queue is full, new frames are dropped instead of stalling the
+   * render loop.
+   */
+  int queueSize{4};
+};
+
+/**
+ * @brief Statistics of a capture session.
+ *
+ * @sa abcg::OpenGLWindow::getCaptureStats.
+ */
+struct abcg::CaptureStats {
+  /** @brief Number of frames queued for writing. */
+  int capturedFrames{};
+  /** @brief Number of frames written to the output. */
+  int writtenFrames{};
+  /** @brief Number of frames dropped because the queue was full or the frame
+   * size changed. */
+  int droppedFrames{};
+  /** @brief Number of frames currently in the queue. */
+  int queueDepth{};
+  /** @brief Maximum number of frames in the queue. */
+  int queueSize{};
+  /** @brief Whether writing to the output failed. */
+  bool writeError{};
+};
+
+/**
+ * @brief Streams the frames of an OpenGL framebuffer to a file.
+ *
+ * Each captured frame is read asynchronously with abcg::OpenGLPixelReader
+ * into a bounded queue of pixel pack buffers, which is drained by a writer
+ * thread. The render thread never waits for the writer: if the queue is full,
+ * the frame is dropped and counted in abcg::CaptureStats::droppedFrames.
+ *
+ * The frame size is fixed by the first captured frame. Frames of a different
+ * size, e.g., after the window is resized, are dropped.
+ */
+class abcg::OpenGLCaptureSession {
+public:
+  void start(CaptureSettings const &settings);
+  void stop();
+  void captureFrame(glm::ivec2 size);
+  void update();
+
+  [[nodiscard]] bool isActive() const noexcept;
+  [[nodiscard]] CaptureStats getStats() const noexcept;
+
+private:
+  void writeFrame(std::span<unsigned char const> pixels, glm::ivec2 size,
+                  int frameIndex);
+  void writeY4MFrame(std::span<unsigned char const> pixels, glm::ivec2 size);
+
+  CaptureSettings m_settings;
+  OpenGLPixelReader m_reader;
+  bool m_active{};
+  glm::ivec2 m_frameSize{};
+  int m_capturedFrames{};
+  int m_droppedFrames{};
+
+  // Accessed only by the writer thread, except in start and stop
+  std::ofstream m_file;
+  std::vector<unsigned char> m_planes;
+  std::atomic<int> m_writtenFrames{};
+  std::atomic<bool> m_writeError{};
+};
+
+#endif
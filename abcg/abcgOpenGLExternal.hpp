@@ -23,6 +23,14 @@
 #include <GL/glew.h>
 #endif
 
+#if defined(ABCG_HEADLESS)
+#if !defined(EGL_NO_X11)
+#define EGL_NO_X11
+#endif
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #if defined(__EMSCRIPTEN__)
 #include <GLES3/gl3.h>
 
@@ -0,0 +1,285 @@
+/**
+ * @file abcgOpenGLPixelReader.cpp
+ * @brief Definition of abcg::OpenGLPixelReader members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLPixelReader.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+constexpr GLuint64 fenceWaitTimeout{1'000'000'000}; // 1 s, in nanoseconds
+
+GLsizeiptr bufferSize(glm::ivec2 size) {
+  return static_cast<GLsizeiptr>(size.x) * size.y * 4;
+}
+} // namespace
+
+/**
+ * @brief Destructor. Calls abcg::OpenGLPixelReader::destroy.
+ */
+abcg::OpenGLPixelReader::~OpenGLPixelReader() { destroy(); }
+
+/**
+ * @brief Creates the pixel pack buffers and starts the worker thread.
+ *
+ * This must be called with the OpenGL context current.
+ *
+ * @param numBuffers Number of pixel pack buffers, i.e., the maximum number of
+ * reads in flight. Two buffers are enough for reading one frame per frame.
+ */
+void abcg::OpenGLPixelReader::create(int numBuffers) {
+  destroy();
+
+  m_slots =
+      std::vector<Slot>(gsl::narrow<std::size_t>(std::max(numBuffers, 1)));
+#if !defined(__EMSCRIPTEN__)
+  for (auto &slot : m_slots) {
+    glGenBuffers(1, &slot.buffer);
+  }
+
+  m_stopWorker = false;
+  m_worker = std::thread(&OpenGLPixelReader::workerLoop, this);
+#endif
+}
+
+/**
+ * @brief Completes the pending reads, stops the worker thread and releases the
+ * pixel pack buffers.
+ *
+ * This must be called with the OpenGL context current.
+ */
+void abcg::OpenGLPixelReader::destroy() {
+  if (m_slots.empty())
+    return;
+
+  finish();
+
+  if (m_worker.joinable()) {
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_stopWorker = true;
+    }
+    m_jobAvailable.notify_one();
+    m_worker.join();
+  }
+
+  for (auto &slot : m_slots) {
+    glDeleteBuffers(1, &slot.buffer);
+  }
+  m_slots.clear();
+  m_next = 0;
+  m_oldest = 0;
+  m_pending = 0;
+}
+
+/**
+ * @brief Reads the pixels of the current read buffer without waiting.
+ *
+ * Issues `glReadPixels` of the rectangle (0, 0, size.x, size.y) of the
+ * current read framebuffer and read buffer (see `glReadBuffer`) into the next
+ * free pixel pack buffer. The consumer is called on the worker thread once
+ * the read has completed on the GPU and abcg::OpenGLPixelReader::update has
+ * found it ready.
+ *
+ * @param size Size of the rectangle to read, in pixels.
+ * @param consumer Function that receives the pixels.
+ *
+ * @returns `true` if the read was issued; `false` if all buffers are busy.
+ */
+bool abcg::OpenGLPixelReader::tryRead(glm::ivec2 size, Consumer consumer) {
+  if (m_slots.empty() || size.x <= 0 || size.y <= 0)
+    return false;
+
+#if defined(__EMSCRIPTEN__)
+  std::vector<unsigned char> pixels(
+      gsl::narrow<std::size_t>(bufferSize(size)));
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  consumer(pixels, size);
+  return true;
+#else
+  // Release the buffers already consumed so that they can be reused
+  collect(false);
+
+  auto &slot{m_slots.at(m_next)};
+  if (slot.state != State::Free)
+    return false;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  if (auto const bytes{bufferSize(size)}; bytes > slot.capacity) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    slot.capacity = bytes;
+  }
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  slot.size = size;
+  slot.consumer = std::move(consumer);
+  slot.consumed.store(false, std::memory_order_relaxed);
+  slot.state = State::Reading;
+
+  m_next = (m_next + 1) % m_slots.size();
+  ++m_pending;
+  return true;
+#endif
+}
+
+/**
+ * @brief Reads the pixels of the current read buffer, waiting for a free
+ * buffer if necessary.
+ *
+ * Same as abcg::OpenGLPixelReader::tryRead, except that if all buffers are
+ * busy, this blocks until the oldest read is consumed.
+ *
+ * @param size Size of the rectangle to read, in pixels.
+ * @param consumer Function that receives the pixels.
+ */
+void abcg::OpenGLPixelReader::read(glm::ivec2 size, Consumer consumer) {
+  while (!m_slots.empty() && !tryRead(size, consumer)) {
+    if (size.x <= 0 || size.y <= 0)
+      return;
+
+    collect(true);
+    std::unique_lock lock{m_mutex};
+    m_jobDone.wait(lock, [this] {
+      auto const &oldest{m_slots.at(m_oldest)};
+      return oldest.state != State::Mapped ||
+             oldest.consumed.load(std::memory_order_acquire);
+    });
+  }
+}
+
+/**
+ * @brief Hands the completed reads to the worker thread and recycles the
+ * buffers already consumed.
+ *
+ * Call this once per frame. It never blocks.
+ */
+void abcg::OpenGLPixelReader::update() { collect(false); }
+
+/**
+ * @brief Blocks until all pending reads have been consumed.
+ */
+void abcg::OpenGLPixelReader::finish() {
+  while (m_pending > 0) {
+    collect(true);
+    if (m_pending == 0)
+      break;
+    std::unique_lock lock{m_mutex};
+    m_jobDone.wait(lock, [this] {
+      return m_slots.at(m_oldest).consumed.load(std::memory_order_acquire);
+    });
+  }
+}
+
+/**
+ * @brief Returns the number of reads not yet consumed.
+ *
+ * @returns Number of buffers that are either waiting for the GPU or being
+ * consumed by the worker thread.
+ */
+int abcg::OpenGLPixelReader::getPendingCount() const noexcept {
+  return m_pending;
+}
+
+/**
+ * @brief Returns the number of pixel pack buffers.
+ *
+ * @returns Maximum number of reads in flight.
+ */
+int abcg::OpenGLPixelReader::getBufferCount() const noexcept {
+  return gsl::narrow_cast<int>(m_slots.size());
+}
+
+void abcg::OpenGLPixelReader::collect([[maybe_unused]] bool wait) {
+#if !defined(__EMSCRIPTEN__)
+  // Map the buffers whose reads have completed, in the order they were issued
+  for (auto const offset : iter::range(m_slots.size())) {
+    auto &slot{m_slots.at((m_oldest + offset) % m_slots.size())};
+    if (slot.state == State::Mapped)
+      continue;
+    if (slot.state == State::Free)
+      break;
+
+    auto status{glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 wait ? fenceWaitTimeout : 0)};
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+      status = glClientWaitSync(slot.fence, 0, fenceWaitTimeout);
+    }
+    if (status == GL_TIMEOUT_EXPIRED)
+      break;
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    auto const bytes{bufferSize(slot.size)};
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    auto const *data{static_cast<unsigned char const *>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT))};
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.state = State::Mapped;
+
+    post([&slot, data, bytes] {
+      if (data != nullptr) {
+        slot.consumer(std::span{data, gsl::narrow<std::size_t>(bytes)},
+                      slot.size);
+      }
+      slot.consumer = nullptr;
+      slot.consumed.store(true, std::memory_order_release);
+    });
+  }
+
+  // Unmap the consumed buffers
+  while (m_pending > 0) {
+    auto &slot{m_slots.at(m_oldest)};
+    if (slot.state != State::Mapped ||
+        !slot.consumed.load(std::memory_order_acquire))
+      break;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.state = State::Free;
+
+    m_oldest = (m_oldest + 1) % m_slots.size();
+    --m_pending;
+  }
+#endif
+}
+
+void abcg::OpenGLPixelReader::post(std::function<void()> job) {
+  {
+    std::scoped_lock const lock{m_mutex};
+    m_jobs.push_back(std::move(job));
+  }
+  m_jobAvailable.notify_one();
+}
+
+void abcg::OpenGLPixelReader::workerLoop() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock{m_mutex};
+      m_jobAvailable.wait(lock,
+                          [this] { return m_stopWorker || !m_jobs.empty(); });
+      if (m_jobs.empty())
+        return;
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job();
+    {
+      // Lock so that a waiting render thread cannot miss the notification
+      std::scoped_lock const lock{m_mutex};
+    }
+    m_jobDone.notify_all();
+  }
+}
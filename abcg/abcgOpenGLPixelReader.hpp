@@ -0,0 +1,108 @@
+/**
+ * @file abcgOpenGLPixelReader.hpp
+ * @brief Header file of abcg::OpenGLPixelReader.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PIXEL_READER_HPP_
+#define ABCG_OPENGL_PIXEL_READER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+class OpenGLPixelReader;
+} // namespace abcg
+
+/**
+ * @brief Asynchronous readback of the OpenGL framebuffer.
+ *
+ * Reads are issued into a ring of pixel pack buffers (PBOs), each one guarded
+ * by a fence. The render thread only issues `glReadPixels` into a free buffer
+ * and, one or more frames later, maps the buffer whose fence has signaled. The
+ * mapped pixels are handed to a consumer function that runs on a worker
+ * thread, and the buffer is unmapped and reused after the consumer returns.
+ * Consumers run in the same order as the reads were issued.
+ *
+ * The number of buffers bounds the number of reads in flight. When all
+ * buffers are busy, abcg::OpenGLPixelReader::tryRead fails immediately, which
+ * lets the caller drop the frame instead of stalling the render loop.
+ *
+ * @remark On WebAssembly, buffers cannot be mapped for reading and there is no
+ * worker thread: reads are synchronous and the consumer is called before
+ * abcg::OpenGLPixelReader::tryRead returns.
+ */
+class abcg::OpenGLPixelReader {
+public:
+  /**
+   * @brief Function that receives the pixels of a completed read.
+   *
+   * The pixels are tightly packed RGBA values, 8 bits per channel, with rows
+   * ordered from bottom to top as returned by `glReadPixels`. The span is
+   * only valid during the call.
+   */
+  using Consumer = std::function<void(std::span<unsigned char const> pixels,
+                                      glm::ivec2 size)>;
+
+  OpenGLPixelReader() = default;
+  OpenGLPixelReader(OpenGLPixelReader const &) = delete;
+  OpenGLPixelReader(OpenGLPixelReader &&) = delete;
+  OpenGLPixelReader &operator=(OpenGLPixelReader const &) = delete;
+  OpenGLPixelReader &operator=(OpenGLPixelReader &&) = delete;
+  ~OpenGLPixelReader();
+
+  void create(int numBuffers = 2);
+  void destroy();
+
+  bool tryRead(glm::ivec2 size, Consumer consumer);
+  void read(glm::ivec2 size, Consumer consumer);
+  void update();
+  void finish();
+
+  [[nodiscard]] int getPendingCount() const noexcept;
+  [[nodiscard]] int getBufferCount() const noexcept;
+
+private:
+  enum class State { Free, Reading, Mapped };
+
+  struct Slot {
+    GLuint buffer{};
+    GLsizeiptr capacity{};
+    GLsync fence{};
+    glm::ivec2 size{};
+    Consumer consumer;
+    State state{State::Free};
+    std::atomic<bool> consumed{false};
+  };
+
+  void collect(bool wait);
+  void post(std::function<void()> job);
+  void workerLoop();
+
+  std::vector<Slot> m_slots;
+  std::size_t m_next{};
+  std::size_t m_oldest{};
+  int m_pending{};
+
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::condition_variable m_jobDone;
+  std::deque<std::function<void()>> m_jobs;
+  bool m_stopWorker{};
+};
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file abcgOpenGLPoster.cpp
+ * @brief Definition of the OpenGL tiled image export helper function.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLPoster.hpp"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <vector>
+
+#include "abcgException.hpp"
+#include "abcgPNGWriter.hpp"
+
+namespace {
+// Matrix that maps the NDC of the region [offset, offset + extent) of an
+// image of the given size to the NDC of a viewport of that region
+glm::mat4 tileMatrix(glm::ivec2 imageSize, glm::ivec2 offset,
+                     glm::ivec2 extent) {
+  auto const image{glm::vec2{imageSize}};
+  auto const tile{glm::vec2{extent}};
+  auto const scale{image / tile};
+  auto const translation{(image - 2.0f * glm::vec2{offset} - tile) / tile};
+
+  glm::mat4 matrix{1.0f};
+  matrix[0][0] = scale.x;
+  matrix[1][1] = scale.y;
+  matrix[3][0] = translation.x;
+  matrix[3][1] = translation.y;
+  return matrix;
+}
+} // namespace
+
+/**
+ * @brief Renders an image tile by tile and saves it as a PNG file.
+ *
+ * Saves images larger than the window or than the maximum size of a
+ * framebuffer, e.g., posters for printing. The image is split into horizontal
+ * bands of rows, and each band into tiles. Each tile is rendered into a
+ * framebuffer object by abcg::OpenGLPosterCreateInfo::paintTile and read into
+ * the band. Completed bands are encoded by abcg::PNGWriter on a worker thread
+ * while the next band is rendered, so the memory used is about twice
+ * abcg::OpenGLPosterCreateInfo::bandMemory, whatever the size of the image.
+ *
+ * The framebuffer binding, viewport and pixel pack parameters are restored
+ * before returning. This must be called with the OpenGL context current.
+ *
+ * @param createInfo Configuration settings.
+ *
+ * @throw abcg::RuntimeError if the size is not valid or the file cannot be
+ * written.
+ */
+void abcg::saveOpenGLPosterPNG(OpenGLPosterCreateInfo const &createInfo) {
+  auto const size{createInfo.size};
+  if (size.x <= 0 || size.y <= 0 || !createInfo.paintTile) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid poster size {}x{}", size.x, size.y));
+  }
+
+  // Largest tile supported by the implementation
+  GLint maxRenderbufferSize{};
+  glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+  std::array<GLint, 2> maxViewportDims{};
+  glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewportDims.data());
+  auto const maxTileSize{std::max(
+      std::min({createInfo.maxTileSize, maxRenderbufferSize,
+                maxViewportDims[0], maxViewportDims[1]}),
+      1)};
+
+  auto const pitch{gsl::narrow<std::size_t>(size.x) * 4};
+  auto const tileWidth{std::min(maxTileSize, size.x)};
+  auto const bandHeight{gsl::narrow<int>(std::clamp<std::size_t>(
+      createInfo.bandMemory / pitch, 1,
+      gsl::narrow<std::size_t>(std::min(maxTileSize, size.y))))};
+
+  // Save the state changed below
+  GLint drawFramebuffer{};
+  GLint readFramebuffer{};
+  GLint pixelPackBuffer{};
+  GLint packRowLength{};
+  GLint packAlignment{};
+  std::array<GLint, 4> viewport{};
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
+  glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+  glGetIntegerv(GL_VIEWPORT, viewport.data());
+
+  GLuint framebuffer{};
+  std::array<GLuint, 2> renderbuffers{};
+  glGenFramebuffers(1, &framebuffer);
+  glGenRenderbuffers(2, renderbuffers.data());
+  glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, tileWidth, bandHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, tileWidth,
+                        bandHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, renderbuffers[0]);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, renderbuffers[1]);
+
+  auto const restoreState{gsl::finally([&] {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                      gsl::narrow_cast<GLuint>(drawFramebuffer));
+    glBindFramebuffer(GL_READ_FRAMEBUFFER,
+                      gsl::narrow_cast<GLuint>(readFramebuffer));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER,
+                 gsl::narrow_cast<GLuint>(pixelPackBuffer));
+    glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(2, renderbuffers.data());
+  })};
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    throw abcg::RuntimeError(fmt::format(
+        "Failed to create a {}x{} tile framebuffer", tileWidth, bandHeight));
+  }
+
+  abcg::PNGWriter writer;
+  writer.open(std::string{createInfo.path}, size.x, size.y);
+
+  // Band rows are read from bottom to top, as returned by glReadPixels, and
+  // written to the PNG from top to bottom
+  auto const writeBand{[&writer, pitch](std::span<unsigned char const> band) {
+    auto const rows{band.size() / pitch};
+    for (auto const row : iter::range(rows)) {
+      writer.writeRows(band.subspan((rows - row - 1) * pitch, pitch));
+    }
+  }};
+
+  std::array<std::vector<unsigned char>, 2> bands;
+  std::future<void> pendingWrite;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glPixelStorei(GL_PACK_ROW_LENGTH, size.x);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  auto bandIndex{0UL};
+  for (auto top{0}; top < size.y; top += bandHeight, ++bandIndex) {
+    auto const rows{std::min(bandHeight, size.y - top)};
+    auto const bottom{size.y - top - rows};
+
+    // The write of this buffer, two bands ago, has already been waited for
+    auto &band{bands.at(bandIndex % bands.size())};
+    band.resize(pitch * gsl::narrow<std::size_t>(rows));
+
+    for (auto left{0}; left < size.x; left += tileWidth) {
+      auto const extent{glm::ivec2{std::min(tileWidth, size.x - left), rows}};
+
+      glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+      glViewport(0, 0, extent.x, extent.y);
+      createInfo.paintTile(tileMatrix(size, {left, bottom}, extent), extent);
+
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+      glReadBuffer(GL_COLOR_ATTACHMENT0);
+      glReadPixels(0, 0, extent.x, extent.y, GL_RGBA, GL_UNSIGNED_BYTE,
+                   band.data() + gsl::narrow<std::size_t>(left) * 4);
+    }
+
+    if (pendingWrite.valid()) {
+      pendingWrite.get();
+    }
+#if defined(__EMSCRIPTEN__)
+    writeBand(band);
+#else
+    pendingWrite = std::async(std::launch::async,
+                              [&writeBand, &band] { writeBand(band); });
+#endif
+  }
+
+  if (pendingWrite.valid()) {
+    pendingWrite.get();
+  }
+  writer.close();
+}
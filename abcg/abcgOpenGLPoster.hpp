@@ -0,0 +1,63 @@
+/**
+ * @file abcgOpenGLPoster.hpp
+ * @brief Declaration of the OpenGL tiled image export helper function.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_POSTER_HPP_
+#define ABCG_OPENGL_POSTER_HPP_
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLExternal.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace abcg {
+struct OpenGLPosterCreateInfo;
+
+void saveOpenGLPosterPNG(OpenGLPosterCreateInfo const &createInfo);
+} // namespace abcg
+
+/**
+ * @brief Configuration settings for saving a tiled PNG image with OpenGL.
+ *
+ * @sa abcg::saveOpenGLPosterPNG.
+ */
+struct abcg::OpenGLPosterCreateInfo {
+  /** @brief Path to the PNG file. */
+  std::string_view path{};
+  /** @brief Size of the image, in pixels. */
+  glm::ivec2 size{};
+  /** @brief Function that renders one tile of the image.
+   *
+   * It is called with the tile framebuffer bound and the viewport set to the
+   * size of the tile. The first argument is the matrix that maps the
+   * normalized device coordinates of the tile region of the whole image to
+   * the normalized device coordinates of the tile: multiply it on the left of
+   * the projection matrix used for the whole image. The second argument is
+   * the size of the tile, in pixels.
+   */
+  std::function<void(glm::mat4 const &tileMatrix, glm::ivec2 tileSize)>
+      paintTile{};
+  /** @brief Maximum width and height of a tile, in pixels.
+   *
+   * Tiles are also limited by `GL_MAX_RENDERBUFFER_SIZE` and
+   * `GL_MAX_VIEWPORT_DIMS`.
+   */
+  int maxTileSize{4096};
+  /** @brief Approximate memory used by each band of rows, in bytes.
+   *
+   * Two bands are kept in memory: one being rendered and one being encoded.
+   * The height of the bands is the number of whole rows that fit in this
+   * budget.
+   */
+  std::size_t bandMemory{64 * 1024 * 1024};
+};
+
+#endif
@@ -0,0 +1,319 @@
+/**
+ * @file abcgOpenGLProfiler.cpp
+ * @brief Definition of abcg::OpenGLProfiler and abcg::OpenGLProfilerZone
+ * members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProfiler.hpp"
+
+#include <algorithm>
+
+#include "abcgExternal.hpp"
+
+namespace {
+// Weight of the latest frame in the moving averages
+constexpr double averageWeight{0.05};
+} // namespace
+
+/**
+ * @brief Creates the ring of frames.
+ *
+ * This must be called with the OpenGL context current. Query objects are
+ * created on demand as zones are recorded.
+ *
+ * @param latency Number of frames in the ring, i.e., the maximum number of
+ * frames in flight whose results are not yet read back.
+ */
+void abcg::OpenGLProfiler::create(int latency) {
+  destroy();
+  m_frames = std::vector<Frame>(gsl::narrow<std::size_t>(std::max(latency, 2)));
+}
+
+/**
+ * @brief Releases the query objects.
+ *
+ * This must be called with the OpenGL context current.
+ */
+void abcg::OpenGLProfiler::destroy() {
+#if !defined(__EMSCRIPTEN__)
+  for (auto &frame : m_frames) {
+    if (!frame.queries.empty()) {
+      glDeleteQueries(gsl::narrow<GLsizei>(frame.queries.size()),
+                      frame.queries.data());
+    }
+  }
+#endif
+  m_frames.clear();
+  m_current = 0;
+  m_oldest = 0;
+  m_recording = false;
+  m_openZones.clear();
+}
+
+/**
+ * @brief Starts measuring a frame.
+ *
+ * Reads back the results of the previous frames that are complete on the GPU,
+ * then issues the timestamp of the start of the frame. Does nothing if the
+ * profiler is disabled.
+ */
+void abcg::OpenGLProfiler::beginFrame() {
+  if (!m_enabled || !isSupported() || m_frames.empty())
+    return;
+
+  resolve();
+
+  auto &frame{m_frames.at(m_current)};
+  if (frame.pending) {
+    // All frames of the ring are in flight
+    ++m_skippedFrames;
+    return;
+  }
+
+  frame.usedQueries = 0;
+  frame.records.clear();
+  m_openZones.clear();
+  m_recording = true;
+  m_frameStart = Clock::now();
+  issueTimestamp(frame);
+}
+
+/**
+ * @brief Finishes measuring a frame.
+ *
+ * Closes the zones left open and issues the timestamp of the end of the
+ * frame.
+ */
+void abcg::OpenGLProfiler::endFrame() {
+  if (!m_recording)
+    return;
+
+  while (!m_openZones.empty()) {
+    endZone();
+  }
+
+  auto &frame{m_frames.at(m_current)};
+  issueTimestamp(frame);
+  frame.cpuTime =
+      std::chrono::duration<double, std::milli>(Clock::now() - m_frameStart)
+          .count();
+  frame.pending = true;
+
+  m_current = (m_current + 1) % m_frames.size();
+  m_recording = false;
+}
+
+/**
+ * @brief Starts a zone of the current frame.
+ *
+ * Does nothing if the current frame is not being measured.
+ *
+ * @param name Name of the zone. Zones of the same name and nesting level in a
+ * frame are added together.
+ */
+void abcg::OpenGLProfiler::beginZone(std::string_view name) {
+  if (!m_recording)
+    return;
+
+  auto iter{std::find(m_names.begin(), m_names.end(), name)};
+  if (iter == m_names.end()) {
+    iter = m_names.emplace(m_names.end(), name);
+  }
+
+  auto &frame{m_frames.at(m_current)};
+  auto const beginQuery{issueTimestamp(frame)};
+  frame.records.push_back(
+      {.name = gsl::narrow<std::size_t>(std::distance(m_names.begin(), iter)),
+       .depth = gsl::narrow<int>(m_openZones.size()),
+       .beginQuery = beginQuery});
+  m_openZones.push_back(frame.records.size() - 1);
+}
+
+/**
+ * @brief Finishes the innermost open zone of the current frame.
+ */
+void abcg::OpenGLProfiler::endZone() {
+  if (!m_recording || m_openZones.empty())
+    return;
+
+  auto &frame{m_frames.at(m_current)};
+  frame.records.at(m_openZones.back()).endQuery = issueTimestamp(frame);
+  m_openZones.pop_back();
+}
+
+/**
+ * @brief Enables or disables the profiler.
+ *
+ * When disabled, all member functions that record frames and zones do
+ * nothing. The last results remain available.
+ *
+ * @param enabled Whether to measure the next frames.
+ */
+void abcg::OpenGLProfiler::setEnabled(bool enabled) noexcept {
+  m_enabled = enabled;
+}
+
+/**
+ * @brief Returns whether the profiler is enabled.
+ *
+ * @returns `true` if the profiler measures the frames; `false` otherwise.
+ */
+bool abcg::OpenGLProfiler::isEnabled() const noexcept { return m_enabled; }
+
+/**
+ * @brief Returns whether timer queries are supported.
+ *
+ * @returns `true` if the profiler can measure GPU times; `false` otherwise.
+ */
+bool abcg::OpenGLProfiler::isSupported() const noexcept {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return true;
+#endif
+}
+
+/**
+ * @brief Returns the GPU times of the zones of the last resolved frame.
+ *
+ * @returns Zones in the order they were started, with the nesting level of
+ * each one.
+ */
+std::vector<abcg::ProfilerZoneTiming> const &
+abcg::OpenGLProfiler::getZoneTimings() const noexcept {
+  return m_zoneTimings;
+}
+
+/**
+ * @brief Returns the GPU time of the last resolved frame.
+ *
+ * @returns Time between the timestamps issued by
+ * abcg::OpenGLProfiler::beginFrame and abcg::OpenGLProfiler::endFrame, in
+ * milliseconds.
+ */
+double abcg::OpenGLProfiler::getGPUFrameTime() const noexcept {
+  return m_gpuFrameTime;
+}
+
+/**
+ * @brief Returns the CPU time of the last resolved frame.
+ *
+ * @returns Wall-clock time between the calls to
+ * abcg::OpenGLProfiler::beginFrame and abcg::OpenGLProfiler::endFrame, in
+ * milliseconds.
+ */
+double abcg::OpenGLProfiler::getCPUFrameTime() const noexcept {
+  return m_cpuFrameTime;
+}
+
+/**
+ * @brief Returns the number of frames not measured because the ring was full.
+ *
+ * @returns Number of skipped frames since the profiler was created.
+ */
+int abcg::OpenGLProfiler::getSkippedFrames() const noexcept {
+  return m_skippedFrames;
+}
+
+std::size_t
+abcg::OpenGLProfiler::issueTimestamp([[maybe_unused]] Frame &frame) {
+#if defined(__EMSCRIPTEN__)
+  return 0;
+#else
+  if (frame.usedQueries == frame.queries.size()) {
+    frame.queries.push_back(0);
+    glGenQueries(1, &frame.queries.back());
+  }
+  glQueryCounter(frame.queries.at(frame.usedQueries), GL_TIMESTAMP);
+  return frame.usedQueries++;
+#endif
+}
+
+void abcg::OpenGLProfiler::resolve() {
+#if !defined(__EMSCRIPTEN__)
+  // Frames complete in the order they were issued
+  while (m_frames.at(m_oldest).pending) {
+    auto &frame{m_frames.at(m_oldest)};
+    GLuint available{};
+    glGetQueryObjectuiv(frame.queries.at(frame.usedQueries - 1),
+                        GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+      break;
+
+    resolveFrame(frame);
+    frame.pending = false;
+    m_oldest = (m_oldest + 1) % m_frames.size();
+  }
+#endif
+}
+
+void abcg::OpenGLProfiler::resolveFrame([[maybe_unused]] Frame &frame) {
+#if !defined(__EMSCRIPTEN__)
+  // Read each query once; differences are taken in integer nanoseconds
+  m_timestamps.resize(frame.usedQueries);
+  for (auto const index : iter::range(frame.usedQueries)) {
+    glGetQueryObjectui64v(frame.queries.at(index), GL_QUERY_RESULT,
+                          &m_timestamps.at(index));
+  }
+  auto const elapsed{[this](std::size_t begin, std::size_t end) {
+    return gsl::narrow_cast<double>(m_timestamps.at(end) -
+                                    m_timestamps.at(begin)) /
+           1'000'000.0;
+  }};
+  auto const average{[](double previous, double current) {
+    return previous + averageWeight * (current - previous);
+  }};
+
+  m_gpuFrameTime = elapsed(0, frame.usedQueries - 1);
+  m_cpuFrameTime = frame.cpuTime;
+
+  m_zoneTimings.clear();
+  for (auto const &record : frame.records) {
+    auto const time{elapsed(record.beginQuery, record.endQuery)};
+    auto const &name{m_names.at(record.name)};
+    if (auto iter{std::ranges::find_if(m_zoneTimings,
+                                       [&](auto const &timing) {
+                                         return timing.name == name &&
+                                                timing.depth == record.depth;
+                                       })};
+        iter != m_zoneTimings.end()) {
+      iter->time += time;
+    } else {
+      m_zoneTimings.push_back(
+          {.name = name, .depth = record.depth, .time = time});
+    }
+  }
+
+  for (auto &timing : m_zoneTimings) {
+    auto key{fmt::format("{}/{}", timing.depth, timing.name)};
+    auto [iter, inserted]{m_averageTimes.try_emplace(std::move(key),
+                                                     timing.time)};
+    if (!inserted) {
+      iter->second = average(iter->second, timing.time);
+    }
+    timing.averageTime = iter->second;
+  }
+#endif
+}
+
+/**
+ * @brief Constructor. Calls abcg::OpenGLProfiler::beginZone.
+ *
+ * @param profiler Profiler of the zone.
+ * @param name Name of the zone.
+ */
+abcg::OpenGLProfilerZone::OpenGLProfilerZone(OpenGLProfiler &profiler,
+                                             std::string_view name)
+    : m_profiler(profiler) {
+  m_profiler.beginZone(name);
+}
+
+/**
+ * @brief Destructor. Calls abcg::OpenGLProfiler::endZone.
+ */
+abcg::OpenGLProfilerZone::~OpenGLProfilerZone() { m_profiler.endZone(); }
@@ -0,0 +1,170 @@
+/**
+ * @file abcgOpenGLProfiler.hpp
+ * @brief Header file of abcg::OpenGLProfiler and abcg::OpenGLProfilerZone.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROFILER_HPP_
+#define ABCG_OPENGL_PROFILER_HPP_
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+struct ProfilerZoneTiming;
+class OpenGLProfiler;
+class OpenGLProfilerZone;
+} // namespace abcg
+
+/**
+ * @brief GPU time of a profiler zone.
+ *
+ * @sa abcg::OpenGLProfiler::getZoneTimings.
+ */
+struct abcg::ProfilerZoneTiming {
+  /** @brief Name of the zone. */
+  std::string name;
+  /** @brief Nesting level of the zone, starting at 0. */
+  int depth{};
+  /** @brief GPU time of the zone in the last resolved frame, in milliseconds.
+   *
+   * If the zone was entered more than once in the frame, this is the sum of
+   * the times of each entry.
+   */
+  double time{};
+  /** @brief Exponential moving average of abcg::ProfilerZoneTiming::time, in
+   * milliseconds. */
+  double averageTime{};
+};
+
+/**
+ * @brief GPU profiler based on OpenGL timer queries.
+ *
+ * Each frame between abcg::OpenGLProfiler::beginFrame and
+ * abcg::OpenGLProfiler::endFrame is measured with `glQueryCounter` timestamps,
+ * as well as each zone between abcg::OpenGLProfiler::beginZone and
+ * abcg::OpenGLProfiler::endZone. Zones can be nested.
+ *
+ * The queries of each frame are kept in a ring of frames and read back only
+ * when `GL_QUERY_RESULT_AVAILABLE` reports them complete, usually two or three
+ * frames later, so reading the results never stalls the pipeline. If the
+ * oldest frame of the ring is still in flight when a new frame begins, the new
+ * frame is not measured.
+ *
+ * The CPU time between abcg::OpenGLProfiler::beginFrame and
+ * abcg::OpenGLProfiler::endFrame is measured as well. A GPU frame time close
+ * to the frame period indicates a GPU-bound frame; a CPU frame time close to
+ * it, a CPU-bound frame.
+ *
+ * @remark Timer queries are not available in WebGL 2.0 without extensions. On
+ * WebAssembly, abcg::OpenGLProfiler::isSupported returns `false` and the
+ * profiler does nothing.
+ *
+ * @sa abcg::OpenGLProfilerZone for a scoped zone.
+ */
+class abcg::OpenGLProfiler {
+public:
+  OpenGLProfiler() = default;
+  OpenGLProfiler(OpenGLProfiler const &) = delete;
+  OpenGLProfiler(OpenGLProfiler &&) = delete;
+  OpenGLProfiler &operator=(OpenGLProfiler const &) = delete;
+  OpenGLProfiler &operator=(OpenGLProfiler &&) = delete;
+  ~OpenGLProfiler() = default;
+
+  void create(int latency = 4);
+  void destroy();
+
+  void beginFrame();
+  void endFrame();
+  void beginZone(std::string_view name);
+  void endZone();
+
+  void setEnabled(bool enabled) noexcept;
+  [[nodiscard]] bool isEnabled() const noexcept;
+  [[nodiscard]] bool isSupported() const noexcept;
+
+  [[nodiscard]] std::vector<ProfilerZoneTiming> const &
+  getZoneTimings() const noexcept;
+  [[nodiscard]] double getGPUFrameTime() const noexcept;
+  [[nodiscard]] double getCPUFrameTime() const noexcept;
+  [[nodiscard]] int getSkippedFrames() const noexcept;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Record {
+    std::size_t name{};
+    int depth{};
+    std::size_t beginQuery{};
+    std::size_t endQuery{};
+  };
+
+  struct Frame {
+    std::vector<GLuint> queries;
+    std::size_t usedQueries{};
+    std::vector<Record> records;
+    double cpuTime{};
+    bool pending{};
+  };
+
+  std::size_t issueTimestamp(Frame &frame);
+  void resolve();
+  void resolveFrame(Frame &frame);
+
+  std::vector<Frame> m_frames;
+  std::size_t m_current{};
+  std::size_t m_oldest{};
+  bool m_enabled{};
+  bool m_recording{};
+  Clock::time_point m_frameStart;
+  std::vector<std::size_t> m_openZones;
+  int m_skippedFrames{};
+
+  // Zone names, interned so that records only store an index
+  std::vector<std::string> m_names;
+
+  std::vector<GLuint64> m_timestamps;
+  std::vector<ProfilerZoneTiming> m_zoneTimings;
+  std::unordered_map<std::string, double> m_averageTimes;
+  double m_gpuFrameTime{};
+  double m_cpuFrameTime{};
+};
+
+/**
+ * @brief Scoped zone of an abcg::OpenGLProfiler.
+ *
+ * Calls abcg::OpenGLProfiler::beginZone on construction and
+ * abcg::OpenGLProfiler::endZone on destruction.
+ *
+ * Example:
+ *
+ * @code
+ * {
+ *   abcg::OpenGLProfilerZone const zone{getProfiler(), "Scene"};
+ *   glDrawArrays(GL_TRIANGLES, 0, count);
+ * }
+ * @endcode
+ */
+class abcg::OpenGLProfilerZone {
+public:
+  OpenGLProfilerZone(OpenGLProfiler &profiler, std::string_view name);
+  OpenGLProfilerZone(OpenGLProfilerZone const &) = delete;
+  OpenGLProfilerZone(OpenGLProfilerZone &&) = delete;
+  OpenGLProfilerZone &operator=(OpenGLProfilerZone const &) = delete;
+  OpenGLProfilerZone &operator=(OpenGLProfilerZone &&) = delete;
+  ~OpenGLProfilerZone();
+
+private:
+  OpenGLProfiler &m_profiler;
+};
+
+#endif
@@ -15,8 +15,12 @@
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl2.h>
 
+#include <string_view>
+#include <vector>
+
 #include "abcgEmbeddedFonts.hpp"
 #include "abcgException.hpp"
+#include "abcgImage.hpp"
 #include "abcgWindow.hpp"
 
 /**
@@ -39,7 +43,7 @@ abcg::OpenGLWindow::getOpenGLSettings() const noexcept {
  */
 void abcg::OpenGLWindow::setOpenGLSettings(
     OpenGLSettings const &openGLSettings) noexcept {
-  if (abcg::Window::getSDLWindow() != nullptr)
+  if (abcg::Window::getSDLWindow() != nullptr || m_headlessFramebuffer != 0)
     return;
   m_openGLSettings = openGLSettings;
 }
@@ -47,33 +51,94 @@ void abcg::OpenGLWindow::setOpenGLSettings(
 /**
  * @brief Takes a snapshot of the screen and saves it to a file.
  *
+ * The pixels are read asynchronously into a pixel pack buffer, and the image
+ * is flipped and encoded to PNG on a worker thread, so this returns without
+ * waiting for the GPU or the encoder. The file is written one or two frames
+ * later. If two screenshots are still in flight, this waits for the oldest
+ * one to complete.
+ *
  * @param filename String view to the filename.
  */
-void abcg::OpenGLWindow::saveScreenshotPNG(std::string_view filename) const {
-  auto const size{getWindowSize()};
-  auto const bitsPerPixel{8};
-  auto const channels{4};
-  auto const pitch{gsl::narrow<long>(size.x * channels)};
+void abcg::OpenGLWindow::saveScreenshotPNG(std::string_view filename) {
+  selectReadBuffer();
+  m_screenshotReader.read(
+      getWindowSize(),
+      [filename = std::string{filename}](std::span<unsigned char const> pixels,
+                                         glm::ivec2 size) {
+        savePNGFromFramebuffer(filename, pixels, size.x, size.y);
+      });
+
+  // Keep painting until the screenshot is written
+  abcg::Window::requestRepaint();
+}
 
-  auto const numPixels{gsl::narrow<std::size_t>(size.x * size.y * channels)};
-  std::vector<unsigned char> pixels(numPixels);
-  glReadBuffer(m_openGLSettings.doubleBuffering ? GL_BACK : GL_FRONT);
-  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+/**
+ * @brief Starts streaming the rendered frames to a file.
+ *
+ * From the next frame on, each painted frame is captured after
+ * abcg::OpenGLWindow::onPaint, without the Dear ImGui controls, and written by
+ * a writer thread in the format given by @a settings. Frames are dropped
+ * instead of stalling the render loop when the writer falls behind; see
+ * abcg::OpenGLWindow::getCaptureStats.
+ *
+ * @param settings Configuration settings of the capture session.
+ *
+ * @throw abcg::RuntimeError if the output file cannot be opened.
+ *
+ * @remark Only painted frames are captured. With on-demand rendering, keep an
+ * animation active (abcg::Window::setAnimationActive) while recording.
+ */
+void abcg::OpenGLWindow::startCapture(CaptureSettings const &settings) {
+  m_captureSession.start(settings);
+}
 
-  // Flip upside down
-  for (auto const line : iter::range(size.y / 2)) {
-    std::swap_ranges(pixels.begin() + pitch * line,
-                     pixels.begin() + pitch * (line + 1),
-                     pixels.begin() + pitch * (size.y - line - 1));
-  }
+/**
+ * @brief Stops the current capture session.
+ *
+ * Blocks until the queued frames are written.
+ */
+void abcg::OpenGLWindow::stopCapture() { m_captureSession.stop(); }
 
-  if (auto *const surface{SDL_CreateRGBSurfaceFrom(
-          pixels.data(), size.x, size.y, channels * bitsPerPixel,
-          gsl::narrow<int>(pitch), 0x000000FF, 0x0000FF00, 0x00FF0000,
-          0xFF000000)}) {
-    IMG_SavePNG(surface, filename.data());
-    SDL_FreeSurface(surface);
-  }
+/**
+ * @brief Returns whether a capture session is active.
+ *
+ * @returns `true` if frames are being captured; `false` otherwise.
+ */
+bool abcg::OpenGLWindow::isCapturing() const noexcept {
+  return m_captureSession.isActive();
+}
+
+/**
+ * @brief Returns the statistics of the current or last capture session.
+ *
+ * @returns Number of captured, written and dropped frames, and the current
+ * depth of the queue.
+ */
+abcg::CaptureStats abcg::OpenGLWindow::getCaptureStats() const noexcept {
+  return m_captureSession.getStats();
+}
+
+/**
+ * @brief Returns the GPU profiler of the window.
+ *
+ * The profiler is disabled by default. When enabled with
+ * abcg::OpenGLProfiler::setEnabled, each painted frame is measured, including
+ * a zone named "ImGui" for the rendering of the Dear ImGui controls. Add
+ * zones to abcg::OpenGLWindow::onPaint with abcg::OpenGLProfilerZone.
+ *
+ * @returns Reference to the profiler.
+ */
+abcg::OpenGLProfiler &abcg::OpenGLWindow::getProfiler() noexcept {
+  return m_profiler;
+}
+
+/**
+ * @brief Returns the GPU profiler of the window.
+ *
+ * @returns Const reference to the profiler.
+ */
+abcg::OpenGLProfiler const &abcg::OpenGLWindow::getProfiler() const noexcept {
+  return m_profiler;
 }
 
 /**
@@ -127,7 +192,9 @@ void abcg::OpenGLWindow::onPaint() {
  *
  * Override it for custom behavior. By default, it shows a FPS counter if
  * abcg::WindowSettings::showFPS is set to `true`, and a toggle fullscreen
- * button if abcg::WindowSettings::showFullscreenButton is set to `true`.
+ * button if abcg::WindowSettings::showFullscreenButton is set to `true`. The
+ * FPS counter includes the GPU times of the frame and of its zones if the
+ * profiler (see abcg::OpenGLWindow::getProfiler) is enabled.
  */
 void abcg::OpenGLWindow::onPaintUI() {
   // FPS counter
@@ -156,6 +223,22 @@ void abcg::OpenGLWindow::onPaintUI() {
                      // *std::ranges::max_element(frames) * 2,
                      *std::max_element(frames.begin(), frames.end()) * 2,
                      ImVec2(gsl::narrow<float>(frames.size()), 50));
+    if (auto const targetFrameRate{
+            abcg::Window::getWindowSettings().targetFrameRate};
+        targetFrameRate > 0) {
+      auto const &pacing{getFramePacingStats()};
+      ImGui::Text("target %d FPS", targetFrameRate);
+      ImGui::Text("pacing %.2f/%.2f ms", pacing.meanError * 1000.0,
+                  pacing.maxError * 1000.0);
+    }
+    if (m_profiler.isEnabled() && m_profiler.isSupported()) {
+      ImGui::Text("GPU %.2f ms, CPU %.2f ms", m_profiler.getGPUFrameTime(),
+                  m_profiler.getCPUFrameTime());
+      for (auto const &zone : m_profiler.getZoneTimings()) {
+        ImGui::Text("%*s%s %.2f ms", 2 * (zone.depth + 1), "",
+                    zone.name.c_str(), zone.averageTime);
+      }
+    }
     ImGui::End();
   }
 
@@ -317,51 +400,18 @@ void abcg::OpenGLWindow::create() {
     break;
   }
 
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, majorVersion);
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, minorVersion);
-  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER,
-                      m_openGLSettings.doubleBuffering ? 1 : 0);
-  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, m_openGLSettings.depthBufferSize);
-  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, m_openGLSettings.stencilBufferSize);
-
-  if (m_openGLSettings.samples > 0) {
-    // Enable multisampling
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-    // Can be 2, 4, 8 or 16
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, m_openGLSettings.samples);
+  if (m_openGLSettings.headless) {
+    createHeadlessContext();
   } else {
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
-  }
-
-  // Create window with graphics context
-  while (true) {
-    if (!createSDLWindow(SDL_WINDOW_OPENGL) && m_openGLSettings.samples > 0) {
-      // Try again, but this time with multisampling disabled
-      m_openGLSettings.samples = 0;
-      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
-      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
-      fmt::print("Warning: multisampling requested but not supported!\n");
-    } else {
-      break;
-    }
-  }
-
-  if (abcg::Window::getSDLWindow() == nullptr) {
-    throw abcg::SDLError("SDL_CreateWindow failed");
-  }
-
-  // Create OpenGL context
-  m_GLContext = SDL_GL_CreateContext(abcg::Window::getSDLWindow());
-  if (m_GLContext == nullptr) {
-    throw abcg::SDLError("SDL_GL_CreateContext failed");
+    createSDLContext();
   }
 
 #if !defined(__EMSCRIPTEN__)
-  SDL_GL_SetSwapInterval(m_openGLSettings.vSync ? 1 : 0);
-#endif
-
-#if !defined(__EMSCRIPTEN__)
-  if (auto const err{glewInit()}; GLEW_OK != err) {
+  // Without a window, glewInit fails to load the GLX/WGL extensions. Only the
+  // OpenGL entry points are required
+  if (auto const err{m_openGLSettings.headless ? glewContextInit()
+                                               : glewInit()};
+      GLEW_OK != err) {
     throw abcg::Exception{
         fmt::format("Failed to initialize OpenGL loader: {}",
                     reinterpret_cast<char const *>(glewGetErrorString(err)))};
@@ -403,9 +453,12 @@ void abcg::OpenGLWindow::create() {
   // call LoadIniSettingsFromMemory() to load settings from your own storage.
   guiIO.IniFilename = nullptr;
 
-  // Setup platform/renderer bindings
-  ImGui_ImplSDL2_InitForOpenGL(abcg::Window::getSDLWindow(), m_GLContext);
-  ImGui_ImplOpenGL3_Init(m_GLSLVersion.c_str());
+  // Setup platform/renderer bindings. In headless mode the ImGui context is
+  // kept only for the window style setup; no UI is rendered
+  if (!m_openGLSettings.headless) {
+    ImGui_ImplSDL2_InitForOpenGL(abcg::Window::getSDLWindow(), m_GLContext);
+    ImGui_ImplOpenGL3_Init(m_GLSLVersion.c_str());
+  }
 
   // Load fonts
   guiIO.Fonts->Clear();
@@ -419,17 +472,274 @@ void abcg::OpenGLWindow::create() {
     throw abcg::RuntimeError("Failed to load font file");
   }
 
+  if (m_openGLSettings.headless) {
+    createHeadlessFramebuffer();
+  }
+
+  m_screenshotReader.create();
+  m_profiler.create();
+
   onCreate();
 
   onResize(getWindowSize());
 }
 
+void abcg::OpenGLWindow::selectReadBuffer() const {
+  if (m_openGLSettings.headless) {
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+  } else {
+    glReadBuffer(m_openGLSettings.doubleBuffering ? GL_BACK : GL_FRONT);
+  }
+}
+
+void abcg::OpenGLWindow::createSDLContext() {
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION,
+                      m_openGLSettings.majorVersion);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION,
+                      m_openGLSettings.minorVersion);
+  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER,
+                      m_openGLSettings.doubleBuffering ? 1 : 0);
+  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, m_openGLSettings.depthBufferSize);
+  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, m_openGLSettings.stencilBufferSize);
+
+  if (m_openGLSettings.samples > 0) {
+    // Enable multisampling
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
+    // Can be 2, 4, 8 or 16
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, m_openGLSettings.samples);
+  } else {
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+  }
+
+  // Create window with graphics context
+  while (true) {
+    if (!createSDLWindow(SDL_WINDOW_OPENGL) && m_openGLSettings.samples > 0) {
+      // Try again, but this time with multisampling disabled
+      m_openGLSettings.samples = 0;
+      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
+      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+      fmt::print("Warning: multisampling requested but not supported!\n");
+    } else {
+      break;
+    }
+  }
+
+  if (abcg::Window::getSDLWindow() == nullptr) {
+    throw abcg::SDLError("SDL_CreateWindow failed");
+  }
+
+  // Create OpenGL context
+  m_GLContext = SDL_GL_CreateContext(abcg::Window::getSDLWindow());
+  if (m_GLContext == nullptr) {
+    throw abcg::SDLError("SDL_GL_CreateContext failed");
+  }
+
+#if !defined(__EMSCRIPTEN__)
+  SDL_GL_SetSwapInterval(m_openGLSettings.vSync ? 1 : 0);
+#endif
+}
+
+void abcg::OpenGLWindow::createHeadlessContext() {
+#if defined(ABCG_HEADLESS)
+  auto const hasExtension{[](char const *extensions, std::string_view name) {
+    if (extensions == nullptr)
+      return false;
+    std::string_view const list{extensions};
+    for (auto pos{list.find(name)}; pos != std::string_view::npos;
+         pos = list.find(name, pos + 1)) {
+      auto const end{pos + name.size()};
+      if ((pos == 0 || list[pos - 1] == ' ') &&
+          (end == list.size() || list[end] == ' '))
+        return true;
+    }
+    return false;
+  }};
+
+  // Prefer Mesa's surfaceless platform, which requires neither a display
+  // server nor a window system
+  if (hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS),
+                   "EGL_MESA_platform_surfaceless")) {
+    if (auto const getPlatformDisplay{
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"))};
+        getPlatformDisplay != nullptr) {
+      m_EGLDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                        EGL_DEFAULT_DISPLAY, nullptr);
+    }
+  }
+  if (m_EGLDisplay == EGL_NO_DISPLAY) {
+    m_EGLDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+  if (m_EGLDisplay == EGL_NO_DISPLAY ||
+      eglInitialize(m_EGLDisplay, nullptr, nullptr) == EGL_FALSE) {
+    throw abcg::RuntimeError("Failed to initialize EGL display");
+  }
+
+  auto const isES{m_openGLSettings.profile == OpenGLProfile::ES};
+  if (eglBindAPI(isES ? EGL_OPENGL_ES_API : EGL_OPENGL_API) == EGL_FALSE) {
+    throw abcg::RuntimeError("Failed to bind OpenGL API to EGL");
+  }
+
+  // Without support for surfaceless contexts, a 1x1 pbuffer surface is
+  // created only to make the context current. The frames are always rendered
+  // into the framebuffer object
+  auto const surfaceless{
+      hasExtension(eglQueryString(m_EGLDisplay, EGL_EXTENSIONS),
+                   "EGL_KHR_surfaceless_context")};
+
+  std::array const configAttributes{
+      EGL_SURFACE_TYPE,
+      surfaceless ? 0 : EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE,
+      isES ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_BIT,
+      EGL_RED_SIZE,
+      8,
+      EGL_GREEN_SIZE,
+      8,
+      EGL_BLUE_SIZE,
+      8,
+      EGL_ALPHA_SIZE,
+      8,
+      EGL_NONE};
+  EGLConfig config{};
+  EGLint numConfigs{};
+  if (eglChooseConfig(m_EGLDisplay, configAttributes.data(), &config, 1,
+                      &numConfigs) == EGL_FALSE ||
+      numConfigs == 0) {
+    throw abcg::RuntimeError("No suitable EGL configuration");
+  }
+
+  std::vector<EGLint> contextAttributes{
+      EGL_CONTEXT_MAJOR_VERSION, m_openGLSettings.majorVersion,
+      EGL_CONTEXT_MINOR_VERSION, m_openGLSettings.minorVersion};
+  if (m_openGLSettings.profile == OpenGLProfile::Core) {
+    contextAttributes.insert(
+        contextAttributes.end(),
+        {EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+         EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE});
+  } else if (m_openGLSettings.profile == OpenGLProfile::Compatibility) {
+    contextAttributes.insert(contextAttributes.end(),
+                             {EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                              EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT});
+  }
+  contextAttributes.push_back(EGL_NONE);
+
+  m_EGLContext = eglCreateContext(m_EGLDisplay, config, EGL_NO_CONTEXT,
+                                  contextAttributes.data());
+  if (m_EGLContext == EGL_NO_CONTEXT) {
+    throw abcg::RuntimeError("eglCreateContext failed");
+  }
+
+  if (!surfaceless) {
+    std::array const surfaceAttributes{EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    m_EGLSurface = eglCreatePbufferSurface(m_EGLDisplay, config,
+                                           surfaceAttributes.data());
+    if (m_EGLSurface == EGL_NO_SURFACE) {
+      throw abcg::RuntimeError("eglCreatePbufferSurface failed");
+    }
+  }
+
+  if (eglMakeCurrent(m_EGLDisplay, m_EGLSurface, m_EGLSurface,
+                     m_EGLContext) == EGL_FALSE) {
+    throw abcg::RuntimeError("eglMakeCurrent failed");
+  }
+#else
+  throw abcg::RuntimeError(
+      "Headless rendering requires ABCg built with ENABLE_HEADLESS");
+#endif
+}
+
+void abcg::OpenGLWindow::createHeadlessFramebuffer() {
+  m_headlessSize = getWindowSize();
+
+  if (m_headlessFramebuffer == 0) {
+    glGenFramebuffers(1, &m_headlessFramebuffer);
+    glGenRenderbuffers(1, &m_headlessColorBuffer);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, m_headlessFramebuffer);
+
+  glBindRenderbuffer(GL_RENDERBUFFER, m_headlessColorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_headlessSize.x,
+                        m_headlessSize.y);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, m_headlessColorBuffer);
+
+  if (m_openGLSettings.depthBufferSize > 0 ||
+      m_openGLSettings.stencilBufferSize > 0) {
+    if (m_headlessDepthBuffer == 0) {
+      glGenRenderbuffers(1, &m_headlessDepthBuffer);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, m_headlessDepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8,
+                          m_headlessSize.x, m_headlessSize.y);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, m_headlessDepthBuffer);
+  }
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    throw abcg::RuntimeError("Headless framebuffer is incomplete");
+  }
+}
+
+void abcg::OpenGLWindow::destroyHeadlessContext() {
+  if (m_headlessFramebuffer != 0) {
+    glDeleteRenderbuffers(1, &m_headlessDepthBuffer);
+    glDeleteRenderbuffers(1, &m_headlessColorBuffer);
+    glDeleteFramebuffers(1, &m_headlessFramebuffer);
+    m_headlessDepthBuffer = 0;
+    m_headlessColorBuffer = 0;
+    m_headlessFramebuffer = 0;
+  }
+
+#if defined(ABCG_HEADLESS)
+  if (m_EGLDisplay != EGL_NO_DISPLAY) {
+    eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    if (m_EGLSurface != EGL_NO_SURFACE) {
+      eglDestroySurface(m_EGLDisplay, m_EGLSurface);
+      m_EGLSurface = EGL_NO_SURFACE;
+    }
+    if (m_EGLContext != EGL_NO_CONTEXT) {
+      eglDestroyContext(m_EGLDisplay, m_EGLContext);
+      m_EGLContext = EGL_NO_CONTEXT;
+    }
+    eglTerminate(m_EGLDisplay);
+    m_EGLDisplay = EGL_NO_DISPLAY;
+  }
+#endif
+}
+
 void abcg::OpenGLWindow::paint() {
   onUpdate();
 
   if (m_hidden || m_minimized)
     return;
 
+  // Hand completed screenshots and captured frames to the writer threads
+  m_screenshotReader.update();
+  m_captureSession.update();
+  if (m_screenshotReader.getPendingCount() > 0) {
+    abcg::Window::requestRepaint();
+  }
+
+  if (m_openGLSettings.headless) {
+    if (getWindowSize() != m_headlessSize) {
+      createHeadlessFramebuffer();
+      onResize(m_headlessSize);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, m_headlessFramebuffer);
+    m_profiler.beginFrame();
+    onPaint();
+    if (m_captureSession.isActive()) {
+      selectReadBuffer();
+      m_captureSession.captureFrame(m_headlessSize);
+    }
+    m_profiler.endFrame();
+    glFlush();
+    return;
+  }
+
   SDL_GL_MakeCurrent(abcg::Window::getSDLWindow(), m_GLContext);
 
 #if defined(__EMSCRIPTEN__)
@@ -443,6 +753,8 @@ void abcg::OpenGLWindow::paint() {
   }
 #endif
 
+  m_profiler.beginFrame();
+
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplSDL2_NewFrame();
   ImGui::NewFrame();
@@ -453,7 +765,17 @@ void abcg::OpenGLWindow::paint() {
 
   onPaint();
 
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  if (m_captureSession.isActive()) {
+    selectReadBuffer();
+    m_captureSession.captureFrame(getWindowSize());
+  }
+
+  {
+    OpenGLProfilerZone const zone{m_profiler, "ImGui"};
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  }
+  m_profiler.endFrame();
+
   if (m_openGLSettings.doubleBuffering) {
     SDL_GL_SwapWindow(abcg::Window::getSDLWindow());
   } else {
@@ -464,11 +786,18 @@ void abcg::OpenGLWindow::paint() {
 void abcg::OpenGLWindow::destroy() {
   onDestroy();
 
+  m_captureSession.stop();
+  m_screenshotReader.destroy();
+  m_profiler.destroy();
+
   if (ImGui::GetCurrentContext() != nullptr) {
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplSDL2_Shutdown();
+    if (!m_openGLSettings.headless) {
+      ImGui_ImplOpenGL3_Shutdown();
+      ImGui_ImplSDL2_Shutdown();
+    }
     ImGui::DestroyContext();
   }
+  destroyHeadlessContext();
   if (m_GLContext != nullptr) {
     SDL_GL_DeleteContext(m_GLContext);
     m_GLContext = nullptr;
@@ -476,9 +805,17 @@ void abcg::OpenGLWindow::destroy() {
 }
 
 [[nodiscard]] glm::ivec2 abcg::OpenGLWindow::getWindowSize() const {
+  if (m_openGLSettings.headless) {
+    auto const &windowSettings{abcg::Window::getWindowSettings()};
+    return {windowSettings.width, windowSettings.height};
+  }
   glm::ivec2 size{};
   if (auto *window{abcg::Window::getSDLWindow()}; window != nullptr) {
     SDL_GL_GetDrawableSize(window, &size.x, &size.y);
   }
   return size;
 }
+
+[[nodiscard]] bool abcg::OpenGLWindow::isHeadless() const noexcept {
+  return m_openGLSettings.headless;
+}
@@ -16,7 +16,10 @@
 #include <string>
 
 #include "abcgExternal.hpp"
+#include "abcgOpenGLCapture.hpp"
 #include "abcgOpenGLFunction.hpp"
+#include "abcgOpenGLPixelReader.hpp"
+#include "abcgOpenGLProfiler.hpp"
 #include "abcgWindow.hpp"
 
 namespace abcg {
@@ -77,6 +80,22 @@ struct abcg::OpenGLSettings {
   bool vSync{false};
   /** @brief Whether the output is double buffered. */
   bool doubleBuffering{true};
+  /** @brief Whether to render offscreen, without creating a window.
+   *
+   * When enabled, the OpenGL context is created with EGL, either without a
+   * surface (`EGL_KHR_surfaceless_context`, e.g. on Mesa's surfaceless
+   * platform) or with a 1x1 pbuffer surface, and the frames are rendered into
+   * a framebuffer object of abcg::WindowSettings::width x
+   * abcg::WindowSettings::height pixels. No display server is required.
+   *
+   * In this mode, Dear ImGui controls are not rendered, multisampling is not
+   * applied, and the application loop is driven with
+   * abcg::Application::create, abcg::Application::paintFrame and
+   * abcg::Application::destroy.
+   *
+   * @remark Requires ABCg built with the `ENABLE_HEADLESS` CMake option.
+   */
+  bool headless{false};
 };
 
 /**
@@ -100,7 +119,15 @@ class abcg::OpenGLWindow : public Window {
 public:
   [[nodiscard]] OpenGLSettings const &getOpenGLSettings() const noexcept;
   void setOpenGLSettings(OpenGLSettings const &openGLSettings) noexcept;
-  void saveScreenshotPNG(std::string_view filename) const;
+  void saveScreenshotPNG(std::string_view filename);
+
+  void startCapture(CaptureSettings const &settings);
+  void stopCapture();
+  [[nodiscard]] bool isCapturing() const noexcept;
+  [[nodiscard]] CaptureStats getCaptureStats() const noexcept;
+
+  [[nodiscard]] OpenGLProfiler &getProfiler() noexcept;
+  [[nodiscard]] OpenGLProfiler const &getProfiler() const noexcept;
 
 protected:
   virtual void onEvent(SDL_Event const &event);
@@ -117,10 +144,35 @@ private:
   void paint() final;
   void destroy() final;
   [[nodiscard]] glm::ivec2 getWindowSize() const final;
+  [[nodiscard]] bool isHeadless() const noexcept final;
+
+  void selectReadBuffer() const;
+  void createSDLContext();
+  void createHeadlessContext();
+  void createHeadlessFramebuffer();
+  void destroyHeadlessContext();
 
   OpenGLSettings m_openGLSettings;
   std::string m_GLSLVersion;
   SDL_GLContext m_GLContext{};
+
+  // Asynchronous readback used by saveScreenshotPNG
+  OpenGLPixelReader m_screenshotReader;
+  OpenGLCaptureSession m_captureSession;
+
+  // GPU timer queries of the frame and of the zones of onPaint
+  OpenGLProfiler m_profiler;
+
+  // Offscreen rendering target used in headless mode
+  GLuint m_headlessFramebuffer{};
+  GLuint m_headlessColorBuffer{};
+  GLuint m_headlessDepthBuffer{};
+  glm::ivec2 m_headlessSize{};
+#if defined(ABCG_HEADLESS)
+  EGLDisplay m_EGLDisplay{EGL_NO_DISPLAY};
+  EGLContext m_EGLContext{EGL_NO_CONTEXT};
+  EGLSurface m_EGLSurface{EGL_NO_SURFACE};
+#endif
   bool m_hidden{};
   bool m_minimized{};
 };
@@ -0,0 +1,209 @@
+/**
+ * @file abcgPNGWriter.cpp
+ * @brief Definition of abcg::PNGWriter members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgPNGWriter.hpp"
+
+#include <array>
+#include <zlib.h>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+
+namespace {
+// Size of each IDAT chunk
+constexpr std::size_t chunkSize{256 * 1024};
+
+void appendBigEndian(std::vector<unsigned char> &bytes, std::uint32_t value) {
+  for (auto const shift : {24, 16, 8, 0}) {
+    bytes.push_back(gsl::narrow_cast<unsigned char>(value >> shift));
+  }
+}
+} // namespace
+
+abcg::PNGWriter::PNGWriter() : m_stream{std::make_unique<z_stream>()} {}
+
+/**
+ * @brief Destructor.
+ *
+ * If the image was not closed with abcg::PNGWriter::close, the file is left
+ * incomplete.
+ */
+abcg::PNGWriter::~PNGWriter() {
+  if (isOpen()) {
+    deflateEnd(m_stream.get());
+  }
+}
+
+/**
+ * @brief Creates the file and writes the PNG header.
+ *
+ * @param filename Name of the file.
+ * @param width Width of the image, in pixels.
+ * @param height Height of the image, in pixels.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created or the size is not
+ * valid.
+ */
+void abcg::PNGWriter::open(std::string const &filename, int width,
+                           int height) {
+  if (isOpen()) {
+    deflateEnd(m_stream.get());
+    m_file.close();
+  }
+
+  if (width <= 0 || height <= 0) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid PNG size {}x{}", width, height));
+  }
+
+  m_file.open(filename, std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    throw abcg::RuntimeError(fmt::format("Failed to create {}", filename));
+  }
+
+  *m_stream = {};
+  if (deflateInit(m_stream.get(), Z_BEST_SPEED) != Z_OK) {
+    m_file.close();
+    throw abcg::RuntimeError("Failed to initialize zlib");
+  }
+
+  m_filename = filename;
+  m_pitch = gsl::narrow<std::size_t>(width) * 4;
+  m_remainingRows = height;
+  m_output.resize(chunkSize);
+  m_stream->next_out = m_output.data();
+  m_stream->avail_out = gsl::narrow<uInt>(m_output.size());
+
+  std::array<unsigned char, 8> const signature{0x89, 'P', 'N',  'G',
+                                               '\r', '\n', 0x1A, '\n'};
+  m_file.write(reinterpret_cast<char const *>(signature.data()),
+               signature.size());
+
+  // 8 bits per channel, RGBA, no interlacing
+  std::vector<unsigned char> header;
+  appendBigEndian(header, gsl::narrow<std::uint32_t>(width));
+  appendBigEndian(header, gsl::narrow<std::uint32_t>(height));
+  header.insert(header.end(), {8, 6, 0, 0, 0});
+  writeChunk("IHDR", header);
+}
+
+/**
+ * @brief Compresses and writes rows of the image.
+ *
+ * @param rows Whole rows of tightly packed RGBA pixels, 8 bits per channel,
+ * ordered from top to bottom. Consecutive calls continue from the last row
+ * written.
+ *
+ * @throw abcg::RuntimeError if the file is not open, if @a rows does not hold
+ * whole rows or exceeds the height of the image, or if writing fails.
+ */
+void abcg::PNGWriter::writeRows(std::span<unsigned char const> rows) {
+  if (!isOpen() || rows.size() % m_pitch != 0 ||
+      rows.size() / m_pitch > gsl::narrow<std::size_t>(m_remainingRows)) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid rows written to {}", m_filename));
+  }
+
+  // Each row is preceded by its filter type (0: none)
+  std::array<unsigned char, 1> constexpr filter{0};
+  for (auto row{rows}; !row.empty(); row = row.subspan(m_pitch)) {
+    deflate(filter, Z_NO_FLUSH);
+    deflate(row.first(m_pitch), Z_NO_FLUSH);
+    --m_remainingRows;
+  }
+}
+
+/**
+ * @brief Finishes the compressed stream and closes the file.
+ *
+ * @throw abcg::RuntimeError if not all rows were written or if writing fails.
+ */
+void abcg::PNGWriter::close() {
+  if (!isOpen())
+    return;
+
+  auto const complete{m_remainingRows == 0};
+  if (complete) {
+    deflate({}, Z_FINISH);
+    writeChunk("IEND", {});
+  }
+  deflateEnd(m_stream.get());
+  m_file.close();
+
+  if (!complete) {
+    throw abcg::RuntimeError(
+        fmt::format("Missing {} rows in {}", m_remainingRows, m_filename));
+  }
+  if (!m_file) {
+    throw abcg::RuntimeError(fmt::format("Failed to write {}", m_filename));
+  }
+}
+
+/**
+ * @brief Returns whether an image is being written.
+ *
+ * @returns `true` between calls to abcg::PNGWriter::open and
+ * abcg::PNGWriter::close; `false` otherwise.
+ */
+bool abcg::PNGWriter::isOpen() const noexcept { return m_file.is_open(); }
+
+void abcg::PNGWriter::deflate(std::span<unsigned char const> input,
+                              int flush) {
+  // zlib does not modify the input, despite the non-const pointer
+  m_stream->next_in = const_cast<Bytef *>(input.data());
+  m_stream->avail_in = gsl::narrow<uInt>(input.size());
+
+  while (true) {
+    auto const result{::deflate(m_stream.get(), flush)};
+    if (result == Z_STREAM_ERROR) {
+      throw abcg::RuntimeError(
+          fmt::format("Failed to compress {}", m_filename));
+    }
+
+    // Write the output buffer as an IDAT chunk when it is full, or what is
+    // left of it at the end of the stream
+    auto const finished{result == Z_STREAM_END};
+    if (m_stream->avail_out == 0 || finished) {
+      writeChunk("IDAT", std::span{m_output}.first(m_output.size() -
+                                                   m_stream->avail_out));
+      m_stream->next_out = m_output.data();
+      m_stream->avail_out = gsl::narrow<uInt>(m_output.size());
+    }
+
+    if (finished || (flush == Z_NO_FLUSH && m_stream->avail_in == 0))
+      break;
+  }
+
+  if (!m_file) {
+    throw abcg::RuntimeError(fmt::format("Failed to write {}", m_filename));
+  }
+}
+
+void abcg::PNGWriter::writeChunk(std::string_view type,
+                                 std::span<unsigned char const> data) {
+  std::vector<unsigned char> header;
+  appendBigEndian(header, gsl::narrow<std::uint32_t>(data.size()));
+  header.insert(header.end(), type.begin(), type.end());
+
+  // The CRC covers the chunk type and the data
+  auto crc{crc32(0, header.data() + 4, 4)};
+  if (!data.empty()) {
+    crc = crc32(crc, data.data(), gsl::narrow<uInt>(data.size()));
+  }
+  std::vector<unsigned char> trailer;
+  appendBigEndian(trailer, gsl::narrow_cast<std::uint32_t>(crc));
+
+  m_file.write(reinterpret_cast<char const *>(header.data()),
+               gsl::narrow<std::streamsize>(header.size()));
+  m_file.write(reinterpret_cast<char const *>(data.data()),
+               gsl::narrow<std::streamsize>(data.size()));
+  m_file.write(reinterpret_cast<char const *>(trailer.data()),
+               gsl::narrow<std::streamsize>(trailer.size()));
+}
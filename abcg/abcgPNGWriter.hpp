@@ -0,0 +1,73 @@
+/**
+ * @file abcgPNGWriter.hpp
+ * @brief Header file of abcg::PNGWriter.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_PNG_WRITER_HPP_
+#define ABCG_PNG_WRITER_HPP_
+
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct z_stream_s;
+
+namespace abcg {
+class PNGWriter;
+} // namespace abcg
+
+/**
+ * @brief Streaming encoder of RGBA PNG images.
+ *
+ * Rows are compressed and written to the file as they are passed to
+ * abcg::PNGWriter::writeRows, so the memory used by the encoder does not
+ * depend on the size of the image. This allows saving images that are too
+ * large to be held in memory at once, e.g., posters rendered tile by tile.
+ *
+ * Example:
+ *
+ * @code
+ * abcg::PNGWriter writer;
+ * writer.open("out.png", width, height);
+ * for (auto const &band : bands) {
+ *   writer.writeRows(band); // Whole rows, from top to bottom
+ * }
+ * writer.close();
+ * @endcode
+ */
+class abcg::PNGWriter {
+public:
+  PNGWriter();
+  PNGWriter(PNGWriter const &) = delete;
+  PNGWriter(PNGWriter &&) = delete;
+  PNGWriter &operator=(PNGWriter const &) = delete;
+  PNGWriter &operator=(PNGWriter &&) = delete;
+  ~PNGWriter();
+
+  void open(std::string const &filename, int width, int height);
+  void writeRows(std::span<unsigned char const> rows);
+  void close();
+
+  [[nodiscard]] bool isOpen() const noexcept;
+
+private:
+  void deflate(std::span<unsigned char const> input, int flush);
+  void writeChunk(std::string_view type, std::span<unsigned char const> data);
+
+  std::unique_ptr<z_stream_s> m_stream;
+  std::ofstream m_file;
+  std::string m_filename;
+  std::vector<unsigned char> m_output;
+  std::size_t m_pitch{};
+  int m_remainingRows{};
+};
+
+#endif
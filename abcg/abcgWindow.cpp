@@ -10,6 +10,8 @@
 
 #include "abcgWindow.hpp"
 
+#include <algorithm>
+
 #include <SDL_video.h>
 
 #include <imgui_impl_sdl2.h>
@@ -173,6 +175,27 @@ double abcg::Window::getDeltaTime() const noexcept { return m_lastDeltaTime; }
  */
 double abcg::Window::getElapsedTime() const { return m_elapsedTime.elapsed(); }
 
+/**
+ * @brief Returns the frame pacing error measured by the frame limiter.
+ *
+ * @returns Reference to the pacing statistics of the last frames. The values
+ * are zero if abcg::WindowSettings::targetFrameRate was never set.
+ */
+abcg::FramePacingStats const &
+abcg::Window::getFramePacingStats() const noexcept {
+  return m_frameLimiter.getStats();
+}
+
+/**
+ * @brief Returns whether the window renders offscreen, without a SDL window.
+ *
+ * Override this function in windows that support headless rendering. By
+ * default, it returns `false`.
+ *
+ * @returns `true` if the window is headless; `false` otherwise.
+ */
+bool abcg::Window::isHeadless() const noexcept { return false; }
+
 /**
  * @brief Returns the current configuration settings of the window.
  *
@@ -209,6 +232,63 @@ void abcg::Window::setWindowSettings(WindowSettings const &windowSettings) {
   m_windowSettings = windowSettings;
 }
 
+/**
+ * @brief Requests the window to be repainted.
+ *
+ * Only meaningful when abcg::WindowSettings::onDemandRendering is enabled, in
+ * which case the window is repainted during the next @a frames iterations of
+ * the application loop. More than one frame is requested by default because
+ * ImGui may need an additional frame to reflect changes in the UI layout.
+ *
+ * @param frames Number of frames to repaint.
+ *
+ * @remark This must be called from the main thread.
+ */
+void abcg::Window::requestRepaint(int frames) noexcept {
+  m_pendingRepaints = std::max(m_pendingRepaints, frames);
+#if defined(__EMSCRIPTEN__)
+  emscripten_resume_main_loop();
+#endif
+}
+
+/**
+ * @brief Sets whether an animation is active.
+ *
+ * While an animation is active, the window is repainted continuously even if
+ * abcg::WindowSettings::onDemandRendering is enabled.
+ *
+ * @param active Whether an animation is active.
+ */
+void abcg::Window::setAnimationActive(bool active) noexcept {
+  if (active && !m_animationActive) {
+    requestRepaint();
+  }
+  m_animationActive = active;
+}
+
+/**
+ * @brief Returns whether an animation is active.
+ *
+ * @returns `true` if an animation is active; `false` otherwise.
+ *
+ * @sa abcg::Window::setAnimationActive.
+ */
+bool abcg::Window::isAnimationActive() const noexcept {
+  return m_animationActive;
+}
+
+/**
+ * @brief Returns whether the window must be repainted in the next iteration of
+ * the application loop.
+ *
+ * @returns `true` if on-demand rendering is disabled, an animation is active,
+ * or a repaint was requested; `false` otherwise.
+ */
+bool abcg::Window::isRepaintNeeded() const noexcept {
+  return !m_windowSettings.onDemandRendering || m_animationActive ||
+         m_pendingRepaints > 0;
+}
+
 /**
  * @brief Returns the SDL window previously created with
  * abcg::Window::createOpenGLWindow or abcg::Window::createVulkanWindow.
@@ -317,6 +397,9 @@ void abcg::Window::toggleFullscreen() {
 void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
   ImGui_ImplSDL2_ProcessEvent(&event);
 
+  // Any event may change the UI state
+  requestRepaint();
+
   if (event.window.windowID != m_windowID)
     return;
 
@@ -391,6 +474,12 @@ void abcg::Window::templateCreate() {
 }
 
 void abcg::Window::templatePaint() {
+  // Time spent idle waiting for events is not part of any frame
+  if (m_idle) {
+    m_deltaTime.restart();
+    m_idle = false;
+  }
+
   // Cap to 480 Hz
   if (m_deltaTime.elapsed() >= 1.0 / 480.0) {
     m_lastDeltaTime = m_deltaTime.restart();
@@ -398,6 +487,10 @@ void abcg::Window::templatePaint() {
     m_lastDeltaTime = 0.0;
   }
 
+  if (m_pendingRepaints > 0) {
+    --m_pendingRepaints;
+  }
+
   paint();
 }
 
@@ -16,6 +16,7 @@
 #include <string>
 
 #include "abcgExternal.hpp"
+#include "abcgFrameLimiter.hpp"
 #include "abcgTimer.hpp"
 
 #if defined(__EMSCRIPTEN__)
@@ -68,6 +69,28 @@ struct abcg::WindowSettings {
   std::string fullscreenElementID{"#canvas"};
   /** @brief String containing the window title. */
   std::string title{"ABCg Window"};
+  /** @brief Whether to repaint the window only when needed.
+   *
+   * When enabled, the application loop blocks waiting for events instead of
+   * repainting continuously. A new frame is painted only after an event is
+   * received, after a call to abcg::Window::requestRepaint, or while an
+   * animation is active (see abcg::Window::setAnimationActive).
+   */
+  bool onDemandRendering{false};
+  /** @brief Maximum time, in milliseconds, the application loop blocks
+   * waiting for events when on-demand rendering is enabled.
+   */
+  int eventWaitTimeout{250};
+  /** @brief Target frame rate, in frames per second, or 0 for no limit.
+   *
+   * When set, the application loop waits between frames so that frames start
+   * at regular intervals. The measured pacing error is returned by
+   * abcg::Window::getFramePacingStats.
+   *
+   * @remark On WebAssembly, the browser schedules the frames with
+   * `setTimeout` at this rate.
+   */
+  int targetFrameRate{0};
 };
 
 /**
@@ -107,6 +130,11 @@ public:
   [[nodiscard]] WindowSettings const &getWindowSettings() const noexcept;
   void setWindowSettings(WindowSettings const &windowSettings);
 
+  void requestRepaint(int frames = 2) noexcept;
+  void setAnimationActive(bool active) noexcept;
+  [[nodiscard]] bool isAnimationActive() const noexcept;
+  [[nodiscard]] bool isRepaintNeeded() const noexcept;
+
 protected:
   /**
    * @brief Custom event handler.
@@ -152,8 +180,11 @@ protected:
    */
   [[nodiscard]] virtual glm::ivec2 getWindowSize() const = 0;
 
+  [[nodiscard]] virtual bool isHeadless() const noexcept;
+
   [[nodiscard]] double getDeltaTime() const noexcept;
   [[nodiscard]] double getElapsedTime() const;
+  [[nodiscard]] FramePacingStats const &getFramePacingStats() const noexcept;
   [[nodiscard]] SDL_Window *getSDLWindow() const noexcept;
   [[nodiscard]] Uint32 getSDLWindowID() const noexcept;
 
@@ -175,9 +206,15 @@ private:
   Timer m_deltaTime;
   Timer m_elapsedTime;
   double m_lastDeltaTime{};
+  FrameLimiter m_frameLimiter;
 
   bool m_enableResizingEventWatcher{true};
 
+  // On-demand rendering state
+  int m_pendingRepaints{1};
+  bool m_animationActive{false};
+  bool m_idle{false};
+
   friend Application;
   friend int resizingEventWatcher(void *data, SDL_Event *event);
 #if defined(__EMSCRIPTEN__)
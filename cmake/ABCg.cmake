@@ -30,7 +30,8 @@ function(enable_abcg project_target)
       PUBLIC "-std=c++20"
       PUBLIC "-Oz"
       PUBLIC "-sUSE_SDL=2"
-      PUBLIC "-sUSE_SDL_IMAGE=2")
+      PUBLIC "-sUSE_SDL_IMAGE=2"
+      PUBLIC "-sUSE_ZLIB=1")
 
     set(LINK_FLAGS "")
     # For debugging, use ASSERTIONS=1 and DISABLE_EXCEPTION_CATCHING=0
@@ -43,6 +44,7 @@ function(enable_abcg project_target)
     list(APPEND LINK_FLAGS "-sMIN_WEBGL_VERSION=2")
     list(APPEND LINK_FLAGS "-sUSE_SDL=2")
     list(APPEND LINK_FLAGS "-sUSE_SDL_IMAGE=2")
+    list(APPEND LINK_FLAGS "-sUSE_ZLIB=1")
     list(APPEND LINK_FLAGS "-sWASM=1")
     list(APPEND LINK_FLAGS "-sSTACK_SIZE=1MB")
     list(APPEND LINK_FLAGS "--use-preload-plugins")
@@ -22,6 +22,9 @@ if(NOT ${CMAKE_SYSTEM_NAME} MATCHES "Emscripten")
     option(ENABLE_IPO "Enable Interprocedural Optimization" ON)
   endif()
 
+  # Headless rendering with EGL (OpenGL only)
+  option(ENABLE_HEADLESS "Enable headless rendering with EGL" OFF)
+
   set(OPTIONS_TARGET options)
   set(SANITIZERS_TARGET sanitizers)
   set(WARNINGS_TARGET warnings)
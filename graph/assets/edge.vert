@@ -0,0 +1,10 @@
+#version 300 es
+precision mediump float;
+
+uniform mat4 projMatrix;
+
+layout(location = 0) in vec2 inPosition;
+
+void main() {
+  gl_Position = projMatrix * vec4(inPosition, 0.0, 1.0);
+}
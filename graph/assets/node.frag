@@ -1,10 +1,28 @@
 #version 300 es
 precision mediump float;
 
-uniform vec3 color;
+uniform vec3 outlineColor;
+uniform float outlineWidth; // Fração do raio; 0 desabilita o contorno
 
-out vec4 fragColor;
+in vec2 fragLocal;
+in vec3 fragColor;
+
+out vec4 outColor;
 
 void main() {
-  fragColor = vec4(color, 1.0);
+  // Distância ao centro, em unidades do raio, e largura de um pixel nessa
+  // unidade para a transição suave das bordas
+  float distance = length(fragLocal);
+  float aa = 0.5 * fwidth(distance);
+
+  float alpha = 1.0 - smoothstep(1.0 - aa, 1.0 + aa, distance);
+  if (alpha <= 0.0) {
+    discard;
+  }
+
+  float inner = 1.0 - outlineWidth;
+  float ring = outlineWidth > 0.0
+                   ? smoothstep(inner - aa, inner + aa, distance)
+                   : 0.0;
+  outColor = vec4(mix(fragColor, outlineColor, ring), alpha);
 }
@@ -1,13 +1,31 @@
 #version 300 es
 precision mediump float;
 
-uniform vec2 translation;
-uniform float scale;
 uniform mat4 projMatrix;
+uniform float pixelsPerUnit;
 
-layout(location = 0) in vec2 inPosition;
+// Canto do quadrado [-1, 1]² que envolve o círculo
+layout(location = 0) in vec2 inCorner;
+
+// Atributos por instância (nó)
+layout(location = 1) in vec2 inTranslation;
+layout(location = 2) in float inRadius;
+layout(location = 3) in vec3 inColor;
+
+out vec2 fragLocal;
+out vec3 fragColor;
 
 void main() {
-  vec2 position = inPosition * scale + translation;
+  // Raio de pelo menos meio pixel, para que nós pequenos não desapareçam, e
+  // margem de um pixel para a borda suavizada
+  float pixel = 1.0 / pixelsPerUnit;
+  float radius = max(inRadius, 0.5 * pixel);
+  float extent = radius + pixel;
+
+  vec2 position = inTranslation + inCorner * extent;
   gl_Position = projMatrix * vec4(position, 0.0, 1.0);
+
+  // Coordenadas locais em unidades do raio: o círculo é length(fragLocal) <= 1
+  fragLocal = inCorner * (extent / radius);
+  fragColor = inColor;
 }
@@ -9,9 +9,10 @@ uniform vec3 textColor;
 out vec4 fragColor;
 
 void main() {
-    vec4 texColor = texture(fontTexture, fragTexCoord);
-    
-    // Utiliza o canal alpha da textura para o texto
-    // Isso assume que é um texto em branco em um fundo transparente na textura
-    fragColor = vec4(textColor, texColor.a);
-}
\ No newline at end of file
+  // O atlas guarda a distância ao contorno do glifo: 0,5 sobre o contorno e
+  // maior dentro. A borda é suavizada ao longo de um pixel da tela
+  float distance = texture(fontTexture, fragTexCoord).r;
+  float aa = 0.5 * fwidth(distance);
+  float alpha = smoothstep(0.5 - aa, 0.5 + aa, distance);
+  fragColor = vec4(textColor, alpha);
+}
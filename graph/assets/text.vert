@@ -1,14 +1,24 @@
 #version 300 es
 precision mediump float;
 
-layout(location = 0) in vec2 inPosition;
-layout(location = 1) in vec2 inTexCoord;
+// Canto do quadrado [0, 1]²
+layout(location = 0) in vec2 inCorner;
+
+// Atributos por instância (glifo)
+layout(location = 1) in vec2 inAnchor;
+layout(location = 2) in vec2 inOffset;
+layout(location = 3) in vec2 inSize;
+layout(location = 4) in vec4 inTexRect;
 
 uniform mat4 projMatrix;
 
 out vec2 fragTexCoord;
 
 void main() {
-  gl_Position = projMatrix * vec4(inPosition, 0.0, 1.0);
-  fragTexCoord = inTexCoord;
-}
\ No newline at end of file
+  vec2 position = inAnchor + inOffset + inCorner * inSize;
+  gl_Position = projMatrix * vec4(position, 0.0, 1.0);
+
+  // O topo do glifo corresponde a (u0, v0) na textura da fonte
+  fragTexCoord = mix(inTexRect.xy, inTexRect.zw,
+                     vec2(inCorner.x, 1.0 - inCorner.y));
+}
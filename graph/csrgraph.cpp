@@ -0,0 +1,32 @@
+// csrgraph.cpp
+
+#include "csrgraph.hpp"
+
+void CSRGraph::build(int numNodes, std::span<Edge const> edges) {
+  auto const n{static_cast<std::size_t>(numNodes)};
+
+  // Contagem dos graus (cada aresta contribui para as duas extremidades)
+  m_offsets.assign(n + 1, 0);
+  for (auto const &edge : edges) {
+    ++m_offsets[static_cast<std::size_t>(edge.nodeA) + 1];
+    ++m_offsets[static_cast<std::size_t>(edge.nodeB) + 1];
+  }
+
+  // Soma de prefixos: m_offsets[i] passa a ser o início da vizinhança de i
+  for (std::size_t i = 1; i <= n; ++i) {
+    m_offsets[i] += m_offsets[i - 1];
+  }
+
+  // Distribui as extremidades nas suas posições (counting sort)
+  m_neighbors.resize(m_offsets[n]);
+  std::vector<std::size_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+  for (auto const &edge : edges) {
+    m_neighbors[cursor[static_cast<std::size_t>(edge.nodeA)]++] = edge.nodeB;
+    m_neighbors[cursor[static_cast<std::size_t>(edge.nodeB)]++] = edge.nodeA;
+  }
+}
+
+void CSRGraph::clear() {
+  m_offsets.clear();
+  m_neighbors.clear();
+}
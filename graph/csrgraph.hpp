@@ -0,0 +1,44 @@
+// csrgraph.hpp
+
+#ifndef CSRGRAPH_HPP_
+#define CSRGRAPH_HPP_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+struct Edge {
+  int nodeA;
+  int nodeB;
+};
+
+// Grafo não dirigido em formato CSR (compressed sparse row). Os vizinhos do
+// nó i ficam contíguos em m_neighbors[m_offsets[i], m_offsets[i + 1]), de
+// modo que grau e vizinhança custam O(1) e travessias custam O(V + E)
+class CSRGraph {
+public:
+  void build(int numNodes, std::span<Edge const> edges);
+  void clear();
+
+  [[nodiscard]] int numNodes() const {
+    return m_offsets.empty() ? 0 : static_cast<int>(m_offsets.size() - 1);
+  }
+  [[nodiscard]] std::size_t numEdges() const { return m_neighbors.size() / 2; }
+
+  [[nodiscard]] int degree(int node) const {
+    auto const index{static_cast<std::size_t>(node)};
+    return static_cast<int>(m_offsets[index + 1] - m_offsets[index]);
+  }
+
+  [[nodiscard]] std::span<int const> neighbors(int node) const {
+    auto const index{static_cast<std::size_t>(node)};
+    return {m_neighbors.data() + m_offsets[index],
+            m_offsets[index + 1] - m_offsets[index]};
+  }
+
+private:
+  std::vector<std::size_t> m_offsets;
+  std::vector<int> m_neighbors;
+};
+
+#endif
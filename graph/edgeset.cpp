@@ -0,0 +1,80 @@
+// edgeset.cpp
+
+#include "edgeset.hpp"
+
+#include <algorithm>
+#include <bit>
+
+void EdgeSet::reserve(std::size_t count) {
+  // Mantém o fator de carga abaixo de 1/2 para `count` arestas
+  auto const capacity{std::bit_ceil(std::max<std::size_t>(2 * count, 16))};
+  if (capacity > m_slots.size()) {
+    rehash(capacity);
+  }
+}
+
+void EdgeSet::clear() {
+  std::fill(m_slots.begin(), m_slots.end(), m_emptySlot);
+  m_size = 0;
+}
+
+bool EdgeSet::insert(int nodeA, int nodeB) {
+  if (2 * (m_size + 1) > m_slots.size()) {
+    rehash(std::max<std::size_t>(2 * m_slots.size(), 16));
+  }
+
+  auto const key{makeKey(nodeA, nodeB)};
+  auto const mask{m_slots.size() - 1};
+  for (auto slot{slotOf(key)};; slot = (slot + 1) & mask) {
+    if (m_slots[slot] == key)
+      return false;
+    if (m_slots[slot] == m_emptySlot) {
+      m_slots[slot] = key;
+      ++m_size;
+      return true;
+    }
+  }
+}
+
+bool EdgeSet::contains(int nodeA, int nodeB) const {
+  if (m_slots.empty())
+    return false;
+
+  auto const key{makeKey(nodeA, nodeB)};
+  auto const mask{m_slots.size() - 1};
+  for (auto slot{slotOf(key)};; slot = (slot + 1) & mask) {
+    if (m_slots[slot] == key)
+      return true;
+    if (m_slots[slot] == m_emptySlot)
+      return false;
+  }
+}
+
+std::uint64_t EdgeSet::makeKey(int nodeA, int nodeB) {
+  auto const lo{static_cast<std::uint32_t>(std::min(nodeA, nodeB))};
+  auto const hi{static_cast<std::uint32_t>(std::max(nodeA, nodeB))};
+  return (static_cast<std::uint64_t>(lo) << 32U) | hi;
+}
+
+std::size_t EdgeSet::slotOf(std::uint64_t key) const {
+  // Hash multiplicativo de Fibonacci: os bits mais altos do produto indexam a
+  // tabela
+  return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> m_shift);
+}
+
+void EdgeSet::rehash(std::size_t capacity) {
+  std::vector<std::uint64_t> oldSlots(capacity, m_emptySlot);
+  oldSlots.swap(m_slots);
+  m_shift = 64 - std::countr_zero(capacity);
+
+  auto const mask{capacity - 1};
+  for (auto const key : oldSlots) {
+    if (key == m_emptySlot)
+      continue;
+    auto slot{slotOf(key)};
+    while (m_slots[slot] != m_emptySlot) {
+      slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = key;
+  }
+}
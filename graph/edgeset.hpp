@@ -0,0 +1,36 @@
+// edgeset.hpp
+
+#ifndef EDGESET_HPP_
+#define EDGESET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Conjunto de arestas não dirigidas com endereçamento aberto (sondagem
+// linear). Cada aresta é guardada como uma chave de 64 bits que empacota
+// (min, max), de modo que {a, b} e {b, a} colidem na mesma chave. A tabela
+// tem capacidade potência de 2 e fator de carga máximo de 1/2, o que garante
+// inserções e consultas em O(1) esperado
+class EdgeSet {
+public:
+  void reserve(std::size_t count);
+  void clear();
+
+  bool insert(int nodeA, int nodeB);
+  [[nodiscard]] bool contains(int nodeA, int nodeB) const;
+  [[nodiscard]] std::size_t size() const { return m_size; }
+
+private:
+  static constexpr std::uint64_t m_emptySlot{~std::uint64_t{0}};
+
+  static std::uint64_t makeKey(int nodeA, int nodeB);
+  [[nodiscard]] std::size_t slotOf(std::uint64_t key) const;
+  void rehash(std::size_t capacity);
+
+  std::vector<std::uint64_t> m_slots;
+  std::size_t m_size{};
+  int m_shift{64};
+};
+
+#endif
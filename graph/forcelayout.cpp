@@ -0,0 +1,333 @@
+// forcelayout.cpp
+
+#include "forcelayout.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <limits>
+#include <utility>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+} // namespace
+
+ForceLayout::~ForceLayout() { stop(); }
+
+void ForceLayout::stop() {
+  if (m_hierarchyThread.joinable()) {
+    m_cancelHierarchy = true;
+    m_hierarchyThread.join();
+    m_cancelHierarchy = false;
+  }
+  m_hierarchyPending = false;
+  m_converged = true;
+}
+
+void ForceLayout::reset(std::span<float const> x, std::span<float const> y,
+                        CSRGraph const &graph, bool refine) {
+  stop();
+  // Só o nível 0 por enquanto: a hierarquia é construída na primeira
+  // iteração, para não atrasar a geração de grafos que não usam o layout
+  m_hierarchy.build(graph, false);
+  m_hierarchyPending = m_settings.multilevel && !refine;
+  m_level = 0;
+  m_x.assign(x.begin(), x.end());
+  m_y.assign(y.begin(), y.end());
+  m_finestX.clear();
+  m_finestY.clear();
+  normalizePositions();
+
+  m_iteration = 0;
+  m_pendingTimings = {};
+  m_timings = {};
+  m_meanDisplacement = 0.0f;
+  startLevel(refine ? m_refineStep : initialStep(), refine);
+}
+
+bool ForceLayout::buildHierarchy(bool wait) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // Sem threads, a hierarquia é construída de uma vez
+  m_nextHierarchy.build(m_hierarchy.graph(0), true);
+#else
+  if (!m_hierarchyThread.joinable()) {
+    m_hierarchyReady = false;
+    m_hierarchyThread = std::thread{[this, &graph = m_hierarchy.graph(0)] {
+      m_nextHierarchy.build(graph, true, &m_cancelHierarchy);
+      m_hierarchyReady = true;
+    }};
+  }
+  if (!wait && !m_hierarchyReady) {
+    return false;
+  }
+  m_hierarchyThread.join();
+#endif
+  m_hierarchyPending = false;
+  m_hierarchy = std::move(m_nextHierarchy);
+  if (m_hierarchy.levelCount() == 1) {
+    return true;
+  }
+
+  // O nível mais grosso parte das médias das posições de cada grupo
+  std::vector<float> coarseX;
+  std::vector<float> coarseY;
+  for (m_level = 0; m_level < m_hierarchy.levelCount() - 1; ++m_level) {
+    m_hierarchy.restrict(m_level, m_x, m_y, coarseX, coarseY);
+    m_x.swap(coarseX);
+    m_y.swap(coarseY);
+  }
+  normalizePositions();
+  startLevel(initialStep(), false);
+  finishLevels();
+  updateFinest();
+  return true;
+}
+
+void ForceLayout::normalizePositions() {
+  // Centraliza na origem e reescala para um quadrado de lado sqrt(n) · K,
+  // a área que n nós ocupam no equilíbrio
+  if (m_x.empty()) {
+    return;
+  }
+  auto const count{static_cast<float>(m_x.size())};
+  auto const [lowX, highX]{std::minmax_element(m_x.begin(), m_x.end())};
+  auto const [lowY, highY]{std::minmax_element(m_y.begin(), m_y.end())};
+  glm::vec2 const center{(*lowX + *highX) * 0.5f, (*lowY + *highY) * 0.5f};
+  auto const extent{std::max(*highX - *lowX, *highY - *lowY)};
+  auto const scale{extent > 0.0f ? std::sqrt(count) / extent : 1.0f};
+  for (std::size_t i = 0; i < m_x.size(); ++i) {
+    m_x[i] = (m_x[i] - center.x) * scale;
+    m_y[i] = (m_y[i] - center.y) * scale;
+  }
+}
+
+float ForceLayout::initialStep() const {
+  return std::max(1.0f, 0.1f * std::sqrt(static_cast<float>(m_x.size())));
+}
+
+void ForceLayout::startLevel(float initialStep, bool refining) {
+  m_graph = &m_hierarchy.graph(m_level);
+  m_forces.assign(m_x.size(), glm::vec2{});
+  m_step = initialStep;
+  m_refining = refining;
+  m_energy = std::numeric_limits<double>::max();
+  m_progress = 0;
+  m_levelIteration = 0;
+  m_iterationStarted = false;
+  m_nextNode = 0;
+  m_converged = m_x.size() < 2;
+}
+
+void ForceLayout::finishLevels() {
+  // Cada nível convergido é ampliado para o nível seguinte, em que o
+  // comprimento natural continua sendo K: a área ocupada cresce com o número
+  // de nós
+  std::vector<float> x;
+  std::vector<float> y;
+  while (m_converged && m_level > 0) {
+    auto const coarseCount{static_cast<float>(m_x.size())};
+    --m_level;
+    auto const count{static_cast<float>(m_hierarchy.graph(m_level).numNodes())};
+    m_hierarchy.prolong(m_level, m_x, m_y, std::sqrt(count / coarseCount),
+                        m_prolongJitter, x, y);
+    m_x.swap(x);
+    m_y.swap(y);
+    startLevel(m_refineStep, true);
+  }
+  if (m_level == 0) {
+    m_finestX = {};
+    m_finestY = {};
+  }
+}
+
+void ForceLayout::updateFinest() {
+  if (m_level == 0) {
+    return;
+  }
+  m_finestX.assign(m_x.begin(), m_x.end());
+  m_finestY.assign(m_y.begin(), m_y.end());
+  std::vector<float> x;
+  std::vector<float> y;
+  for (auto level{m_level - 1}; level >= 0; --level) {
+    m_hierarchy.prolong(level, m_finestX, m_finestY, 1.0f, 0.0f, x, y);
+    m_finestX.swap(x);
+    m_finestY.swap(y);
+  }
+}
+
+int ForceLayout::run(double timeBudget) {
+  m_pool.resize(m_settings.numThreads);
+  if (m_hierarchyPending && !buildHierarchy(false)) {
+    return 0;
+  }
+  auto const start{Clock::now()};
+  auto const elapsed{[&] {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }};
+
+  // Cada fatia tem m_sliceSize nós por thread
+  auto const sliceSize{m_sliceSize *
+                       static_cast<std::size_t>(m_pool.threadCount())};
+  int iterations{0};
+  while (!m_converged) {
+    if (!m_iterationStarted) {
+      beginIteration();
+    }
+    while (m_nextNode < m_x.size()) {
+      auto const end{std::min(m_nextNode + sliceSize, m_x.size())};
+      computeForces(m_nextNode, end);
+      m_nextNode = end;
+      if (elapsed() >= timeBudget) {
+        break;
+      }
+    }
+    if (m_nextNode < m_x.size()) {
+      break;
+    }
+    finishIteration();
+    ++iterations;
+
+    if (elapsed() >= timeBudget) {
+      break;
+    }
+  }
+  if (iterations > 0) {
+    updateFinest();
+  }
+  return iterations;
+}
+
+void ForceLayout::step() {
+  if (m_converged || m_graph == nullptr) {
+    return;
+  }
+  m_pool.resize(m_settings.numThreads);
+  if (m_hierarchyPending) {
+    buildHierarchy(true);
+    if (m_converged) {
+      return;
+    }
+  }
+  if (!m_iterationStarted) {
+    beginIteration();
+  }
+  computeForces(m_nextNode, m_x.size());
+  m_nextNode = m_x.size();
+  finishIteration();
+  updateFinest();
+}
+
+void ForceLayout::beginIteration() {
+  auto const phaseStart{Clock::now()};
+  m_tree.build(m_x, m_y, m_pool);
+  m_iterationStarted = true;
+  m_nextNode = 0;
+  m_pendingTimings.tree += millisecondsSince(phaseStart);
+}
+
+void ForceLayout::computeForces(std::size_t begin, std::size_t end) {
+  // Repulsão C·K²/d (K = 1) de todos os nós, atração d²/K dos vizinhos e
+  // gravidade linear para a origem. [begin, end) são posições na ordem de
+  // Morton, divididas em grupos de m_groupSize nós próximos no espaço que
+  // compartilham um único percurso da quadtree
+  auto const phaseStart{Clock::now()};
+  auto const &kernels{m_settings.useSimd ? layoutKernels()
+                                         : scalarLayoutKernels()};
+  auto const order{m_tree.order()};
+  auto const numGroups{(end - begin + m_groupSize - 1) / m_groupSize};
+  m_pool.forEachChunk(
+      numGroups, (numGroups + 31) / 32,
+      [&](std::size_t, std::size_t firstGroup, std::size_t lastGroup) {
+        RepulsionSources sources;
+        for (auto group{firstGroup}; group < lastGroup; ++group) {
+          auto const groupBegin{begin + group * m_groupSize};
+          auto const groupEnd{std::min(groupBegin + m_groupSize, end)};
+          m_tree.collectSources(groupBegin, groupEnd, m_settings.theta,
+                                sources);
+          for (auto k{groupBegin}; k < groupEnd; ++k) {
+            auto const node{order[k]};
+            glm::vec2 const position{m_x[node], m_y[node]};
+            auto const neighbors{m_graph->neighbors(static_cast<int>(node))};
+            m_forces[node] =
+                kernels.repulsion(position, sources.x.data(),
+                                  sources.y.data(), sources.mass.data(),
+                                  sources.size(), m_settings.repulsion) +
+                kernels.attraction(position, m_x.data(), m_y.data(),
+                                   neighbors.data(), neighbors.size()) -
+                m_settings.gravity * position;
+          }
+        }
+      });
+  m_pendingTimings.forces += millisecondsSince(phaseStart);
+}
+
+void ForceLayout::finishIteration() {
+  auto const phaseStart{Clock::now()};
+
+  // Cada nó anda na direção da força, no máximo m_step. Deslocamento e
+  // energia (soma de |F|²) são somados por bloco e depois na ordem dos blocos
+  auto const count{m_x.size()};
+  auto const numChunks{(count + m_integrationChunkSize - 1) /
+                       m_integrationChunkSize};
+  std::vector<std::pair<double, double>> sums(numChunks);
+  auto const maxStep{m_step};
+  m_pool.forEachChunk(
+      count, numChunks,
+      [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        double displacement{0.0};
+        double energy{0.0};
+        for (auto i{begin}; i < end; ++i) {
+          auto const length2{glm::dot(m_forces[i], m_forces[i])};
+          energy += length2;
+          if (length2 > 0.0f) {
+            auto const length{std::sqrt(length2)};
+            auto const distance{std::min(length, maxStep)};
+            auto const move{m_forces[i] * (distance / length)};
+            m_x[i] += move.x;
+            m_y[i] += move.y;
+            displacement += distance;
+          }
+        }
+        sums[chunk] = {displacement, energy};
+      });
+  double displacement{0.0};
+  double energy{0.0};
+  for (auto const &[chunkDisplacement, chunkEnergy] : sums) {
+    displacement += chunkDisplacement;
+    energy += chunkEnergy;
+  }
+
+  // Resfriamento adaptativo (Hu): passo maior enquanto a energia diminui,
+  // menor quando ela volta a subir. Os níveis refinados partem de um layout
+  // quase pronto e só esfriam
+  if (m_refining) {
+    m_step *= m_refineCooling;
+  } else if (energy < m_energy) {
+    if (++m_progress >= 5) {
+      m_progress = 0;
+      m_step /= m_settings.cooling;
+    }
+  } else {
+    m_progress = 0;
+    m_step *= m_settings.cooling;
+  }
+  m_energy = energy;
+  m_iterationStarted = false;
+
+  ++m_iteration;
+  ++m_levelIteration;
+  m_meanDisplacement = static_cast<float>(
+      displacement / static_cast<double>(std::max<std::size_t>(count, 1)));
+  m_converged = m_meanDisplacement < m_settings.tolerance ||
+                m_levelIteration >= m_settings.maxIterations;
+  finishLevels();
+
+  m_pendingTimings.integration += millisecondsSince(phaseStart);
+  m_timings = std::exchange(m_pendingTimings, {});
+}
@@ -0,0 +1,183 @@
+// forcelayout.hpp
+
+#ifndef FORCELAYOUT_HPP_
+#define FORCELAYOUT_HPP_
+
+#include <atomic>
+#include <glm/vec2.hpp>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "csrgraph.hpp"
+#include "layoutkernels.hpp"
+#include "multilevel.hpp"
+#include "parallel.hpp"
+#include "quadtree.hpp"
+#include "threadpool.hpp"
+
+// Parâmetros do layout de forças
+struct ForceLayoutSettings {
+  float theta{1.2f};      // Abertura do Barnes–Hut (0 = repulsão exata)
+  float repulsion{0.2f};  // C do modelo mola-elétrico
+  float gravity{0.01f};   // Atração para a origem (segura componentes soltas)
+  float cooling{0.9f};    // Fator t do resfriamento adaptativo
+  float tolerance{0.01f}; // Deslocamento médio de parada, em unidades de K
+  int maxIterations{3000}; // Por nível
+  bool multilevel{true};    // Começa pelos níveis mais grossos da hierarquia
+  int numThreads{defaultThreadCount()};
+  bool useSimd{true}; // Kernels SIMD; desmarcado usa a versão escalar
+};
+
+// Tempo de cada etapa de uma iteração, em milissegundos
+struct ForceLayoutTimings {
+  double tree{};        // Ordenação de Morton e construção da quadtree
+  double forces{};      // Repulsão, atração e gravidade
+  double integration{}; // Deslocamento dos nós e resfriamento
+
+  [[nodiscard]] double total() const { return tree + forces + integration; }
+};
+
+// Layout de forças no modelo mola-elétrico de Fruchterman–Reingold, com
+// repulsão C·K²/d calculada pela quadtree de Barnes–Hut em O(n log n),
+// atração d²/K ao longo das arestas e uma gravidade fraca. O comprimento
+// natural K vale 1 no espaço do layout. O passo segue o resfriamento
+// adaptativo de Yifan Hu: diminui por um fator t quando a energia (soma de
+// |F|²) aumenta e aumenta após cinco iterações seguidas de melhora. O layout
+// converge quando o deslocamento médio dos nós fica abaixo de
+// tolerance · K. Uma iteração pode ser dividida entre vários quadros: as
+// forças são calculadas em fatias de nós até esgotar o orçamento de tempo, e
+// as posições só mudam quando todas as forças da iteração estão prontas.
+//
+// As três etapas rodam em paralelo no ThreadPool, com
+// ForceLayoutSettings::numThreads threads. A força de cada nó é calculada
+// de forma independente, na ordem de Morton da quadtree, e as somas de
+// energia e deslocamento são feitas por blocos fixos e acumuladas na ordem
+// dos blocos, então o resultado é o mesmo para qualquer número de threads.
+// As coordenadas ficam em estrutura de arrays, lidas diretamente pelos
+// kernels SIMD da repulsão e da atração.
+//
+// Com ForceLayoutSettings::multilevel, o layout percorre a hierarquia de
+// GraphHierarchy do nível mais grosso ao grafo original: o nível mais grosso
+// parte das posições dadas (médias dos grupos) e, quando um nível converge,
+// as suas posições, ampliadas por sqrt(n do nível / n do nível grosso),
+// são o ponto de partida do nível seguinte. Os níveis refinados começam com
+// passo m_refineStep, reduzido por m_refineCooling a cada iteração: cada
+// nível só corrige detalhes locais, então poucas iterações bastam mesmo em
+// grafos com milhões de nós. A hierarquia é construída em uma thread
+// separada (dezenas de segundos com 10⁷ nós); enquanto isso run() retorna
+// sem iterar, e step() espera por ela
+class ForceLayout {
+public:
+  ForceLayout() = default;
+  ~ForceLayout();
+
+  ForceLayout(ForceLayout const &) = delete;
+  ForceLayout &operator=(ForceLayout const &) = delete;
+
+  // Reinicia a partir das posições dadas (em qualquer escala; são
+  // reescaladas para uma área proporcional ao número de nós). `graph`
+  // precisa continuar válido enquanto o layout for usado. Com `refine`, as
+  // posições já formam um layout (Pivot-MDS, por exemplo) e são apenas
+  // refinadas, como um nível refinado da hierarquia multinível
+  void reset(std::span<float const> x, std::span<float const> y,
+             CSRGraph const &graph, bool refine = false);
+
+  // Avança o layout por cerca de `timeBudget` segundos (pelo menos uma
+  // fatia de nós), ou até convergir. Retorna o número de iterações
+  // concluídas, isto é, de vezes que as posições mudaram
+  int run(double timeBudget);
+
+  // Conclui a iteração atual, sem limite de tempo
+  void step();
+
+  // Interrompe a construção da hierarquia, que lê o grafo dado a reset, e
+  // para o layout até o próximo reset. Precisa ser chamada antes de alterar
+  // o grafo
+  void stop();
+
+  [[nodiscard]] bool converged() const { return m_converged; }
+  [[nodiscard]] bool buildingHierarchy() const { return m_hierarchyPending; }
+  // Iterações concluídas, somando todos os níveis
+  [[nodiscard]] int iteration() const { return m_iteration; }
+  // Nível em andamento (0 = grafo original) e número de níveis
+  [[nodiscard]] int level() const { return m_level; }
+  [[nodiscard]] int levelCount() const { return m_hierarchy.levelCount(); }
+  [[nodiscard]] float meanDisplacement() const { return m_meanDisplacement; }
+  // Tempo de processamento da última iteração, somando as suas fatias
+  [[nodiscard]] double iterationTime() const { return m_timings.total(); }
+  [[nodiscard]] ForceLayoutTimings const &timings() const {
+    return m_timings;
+  }
+  // Posições dos nós do grafo original; nos níveis grossos, cada nó ocupa a
+  // posição do grupo que o contém
+  [[nodiscard]] std::span<float const> x() const {
+    return m_level == 0 ? m_x : m_finestX;
+  }
+  [[nodiscard]] std::span<float const> y() const {
+    return m_level == 0 ? m_y : m_finestY;
+  }
+
+  [[nodiscard]] ForceLayoutSettings &settings() { return m_settings; }
+
+private:
+  // Retorna falso se a hierarquia ainda está em construção e `wait` é falso
+  bool buildHierarchy(bool wait);
+  void normalizePositions();
+  [[nodiscard]] float initialStep() const;
+  void startLevel(float initialStep, bool refining);
+  void finishLevels();
+  void updateFinest();
+  void beginIteration();
+  void computeForces(std::size_t begin, std::size_t end);
+  void finishIteration();
+
+  // Nós por fatia e por thread entre duas verificações do orçamento de tempo
+  static constexpr std::size_t m_sliceSize{2048};
+  // Nós consecutivos na ordem de Morton que compartilham a lista de fontes
+  // da repulsão; as fatias são múltiplas deste tamanho
+  static constexpr std::size_t m_groupSize{8};
+  // Nós por bloco da integração
+  static constexpr std::size_t m_integrationChunkSize{16384};
+  // Passo inicial e resfriamento dos níveis refinados, e desvio dos nós de
+  // um mesmo grupo ao ampliar um nível, em unidades de K
+  static constexpr float m_refineStep{1.0f};
+  static constexpr float m_refineCooling{0.8f};
+  static constexpr float m_prolongJitter{0.1f};
+
+  ForceLayoutSettings m_settings;
+  GraphHierarchy m_hierarchy;
+  bool m_hierarchyPending{false};
+  int m_level{};
+  CSRGraph const *m_graph{}; // Grafo do nível em andamento
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<glm::vec2> m_forces;
+  std::vector<float> m_finestX; // x() e y() nos níveis grossos
+  std::vector<float> m_finestY;
+  QuadTree m_tree;
+  ThreadPool m_pool;
+
+  // Construção da hierarquia em andamento
+  GraphHierarchy m_nextHierarchy;
+  std::thread m_hierarchyThread;
+  std::atomic<bool> m_hierarchyReady{false};
+  std::atomic<bool> m_cancelHierarchy{false};
+
+  // Iteração em andamento: forças prontas para os nós [0, m_nextNode)
+  bool m_iterationStarted{false};
+  std::size_t m_nextNode{};
+  ForceLayoutTimings m_pendingTimings;
+
+  float m_step{};
+  bool m_refining{false};
+  double m_energy{};
+  int m_progress{};
+  int m_iteration{};
+  int m_levelIteration{};
+  float m_meanDisplacement{};
+  ForceLayoutTimings m_timings;
+  bool m_converged{true};
+};
+
+#endif
@@ -0,0 +1,604 @@
+// generators.cpp
+
+#include "generators.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+#include "parallel.hpp"
+
+namespace {
+// Distância até o próximo sucesso em uma sequência de ensaios de Bernoulli
+// com probabilidade p: 1 + floor(log(1 - r) / log(1 - p)), com r em [0, 1)
+class GeometricSkip {
+public:
+  explicit GeometricSkip(double probability)
+      : m_logQ{probability >= 1.0 ? 0.0 : std::log1p(-probability)} {}
+
+  std::int64_t operator()(CounterRng &rng) {
+    if (m_logQ == 0.0)
+      return 1;
+    auto const skip{std::floor(std::log1p(-rng.uniform()) / m_logQ)};
+    // Saltos maiores que qualquer intervalo real encerram a enumeração
+    constexpr auto maxSkip{
+        static_cast<double>(std::numeric_limits<std::int64_t>::max() / 2)};
+    return 1 + static_cast<std::int64_t>(std::min(skip, maxSkip));
+  }
+
+private:
+  double m_logQ;
+};
+
+void reserveExpected(std::vector<Edge> &edges, std::int64_t pairs,
+                     double probability) {
+  // Média mais uma folga de alguns desvios-padrão da binomial, nunca acima
+  // do limite de arestas esperadas
+  auto const mean{std::min(static_cast<double>(pairs) * probability,
+                           static_cast<double>(maxExpectedEdges))};
+  auto const slack{4.0 * std::sqrt(mean) + 16.0};
+  edges.reserve(edges.size() + static_cast<std::size_t>(mean + slack));
+}
+
+// Modelo de ligação preferencial do Barabási–Albert. A aresta e pertence
+// ao nó source(e) = 1 + e / m; no vetor de extremidades ela ocupa as posições
+// 2e (origem) e 2e + 1 (destino). O destino copia a extremidade de uma posição
+// sorteada entre as arestas dos nós anteriores, de modo que nunca há laços
+class PreferentialAttachment {
+public:
+  PreferentialAttachment(int edgesPerNode, std::uint64_t seed)
+      : m_edgesPerNode{static_cast<std::uint64_t>(edgesPerNode)}, m_rng{seed} {}
+
+  [[nodiscard]] int source(std::uint64_t edge) const {
+    return static_cast<int>(1 + edge / m_edgesPerNode);
+  }
+
+  // Posição sorteada para o destino da aresta, ou nenhuma para o nó 1, que
+  // só pode ligar-se ao nó 0
+  [[nodiscard]] std::optional<std::uint64_t>
+  sampledSlot(std::uint64_t edge) const {
+    auto const previousSlots{2 * (edge / m_edgesPerNode) * m_edgesPerNode};
+    if (previousSlots == 0)
+      return std::nullopt;
+    return CounterRng::scale(m_rng.at(edge), previousSlots);
+  }
+
+  // Destino resolvido sem o vetor: posições pares são origens (conhecidas);
+  // posições ímpares são destinos de arestas anteriores
+  [[nodiscard]] int target(std::uint64_t edge) const {
+    while (true) {
+      auto const slot{sampledSlot(edge)};
+      if (!slot)
+        return 0;
+      if (*slot % 2 == 0)
+        return source(*slot / 2);
+      edge = *slot / 2;
+    }
+  }
+
+  // Grava as arestas do nó `node` em `out`, sem repetições, e retorna quantas
+  // foram gravadas
+  template <typename TargetFn>
+  std::size_t emitNode(int node, TargetFn &&targetOf, Edge *out) const {
+    auto const firstEdge{static_cast<std::uint64_t>(node - 1) *
+                         m_edgesPerNode};
+    std::size_t count{0};
+    for (std::uint64_t j = 0; j < m_edgesPerNode; ++j) {
+      auto const target{targetOf(firstEdge + j)};
+      if (std::none_of(out, out + count,
+                       [&](Edge const &e) { return e.nodeB == target; })) {
+        out[count++] = {node, target};
+      }
+    }
+    return count;
+  }
+
+private:
+  std::uint64_t m_edgesPerNode;
+  CounterRng m_rng;
+};
+
+// Radix sort LSD paralelo de chaves com `keyBits` bits significativos, 11
+// bits por passada. Em cada passada cada bloco conta os seus dígitos, as
+// contagens são acumuladas na ordem (dígito, bloco) e cada bloco espalha as
+// suas chaves nas posições resultantes, o que mantém a ordenação estável
+void parallelRadixSort(std::vector<std::uint64_t> &keys, int keyBits,
+                       int numThreads) {
+  constexpr int digitBits{11};
+  constexpr std::size_t radix{std::size_t{1} << digitBits};
+  auto const numChunks{static_cast<std::size_t>(std::max(numThreads, 1))};
+  std::vector<std::array<std::size_t, radix>> offsets(numChunks);
+  std::vector<std::uint64_t> buffer(keys.size());
+
+  for (int shift = 0; shift < keyBits; shift += digitBits) {
+    auto const digit{[shift](std::uint64_t key) {
+      return static_cast<std::size_t>((key >> shift) & (radix - 1));
+    }};
+
+    parallelChunks(keys.size(), numChunks, numThreads,
+                   [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                     auto &count{offsets[chunk]};
+                     count.fill(0);
+                     for (auto i{begin}; i < end; ++i) {
+                       ++count[digit(keys[i])];
+                     }
+                   });
+
+    std::size_t position{0};
+    for (std::size_t d = 0; d < radix; ++d) {
+      for (auto &count : offsets) {
+        position += std::exchange(count[d], position);
+      }
+    }
+
+    parallelChunks(keys.size(), numChunks, numThreads,
+                   [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                     auto &next{offsets[chunk]};
+                     for (auto i{begin}; i < end; ++i) {
+                       buffer[next[digit(keys[i])]++] = keys[i];
+                     }
+                   });
+    keys.swap(buffer);
+  }
+}
+} // namespace
+
+std::int64_t maxEdgeCount(int numNodes) {
+  auto const n{static_cast<std::int64_t>(std::max(numNodes, 0))};
+  return n * (n - 1) / 2;
+}
+
+double limitProbability(std::int64_t pairs, double probability) {
+  auto const expected{static_cast<double>(pairs) * probability};
+  auto const limit{static_cast<double>(maxExpectedEdges)};
+  return expected > limit ? limit / static_cast<double>(pairs) : probability;
+}
+
+double expectedBlockModelEdges(int numNodes, int numBlocks,
+                               double probabilityIn, double probabilityOut) {
+  numBlocks = std::clamp(numBlocks, 1, std::max(numNodes, 1));
+  std::int64_t pairsIn{0};
+  for (int block = 0; block < numBlocks; ++block) {
+    auto const size{static_cast<std::int64_t>(block + 1) * numNodes /
+                        numBlocks -
+                    static_cast<std::int64_t>(block) * numNodes / numBlocks};
+    pairsIn += maxEdgeCount(static_cast<int>(size));
+  }
+  auto const pairsOut{maxEdgeCount(numNodes) - pairsIn};
+  return static_cast<double>(pairsIn) * probabilityIn +
+         static_cast<double>(pairsOut) * probabilityOut;
+}
+
+void sampleUniqueEdges(int first, int last, std::int64_t count,
+                       std::int64_t existing, EdgeSet &edgeSet,
+                       std::vector<Edge> &edges, CounterRng &rng) {
+  auto const freePairs{maxEdgeCount(last - first) - existing};
+  count = std::clamp<std::int64_t>(count, 0,
+                                   std::min(freePairs, maxExpectedEdges));
+  if (count == 0)
+    return;
+
+  edges.reserve(edges.size() + static_cast<std::size_t>(count));
+  edgeSet.reserve(edgeSet.size() + static_cast<std::size_t>(count));
+
+  if (2 * count <= freePairs) {
+    // Grafo esparso: rejeição de laços e de pares repetidos
+    auto const range{static_cast<std::uint64_t>(last - first)};
+    for (std::int64_t inserted{0}; inserted < count;) {
+      auto const a{first + static_cast<int>(rng.below(range))};
+      auto const b{first + static_cast<int>(rng.below(range))};
+      if (a != b && edgeSet.insert(a, b)) {
+        edges.push_back({a, b});
+        ++inserted;
+      }
+    }
+    return;
+  }
+
+  // Grafo denso: percorre os pares livres (menos de 2 * count) e escolhe
+  // cada um com probabilidade (faltantes) / (restantes), o que dá uma amostra
+  // uniforme de exatamente `count` pares
+  auto remaining{static_cast<std::uint64_t>(freePairs)};
+  auto needed{static_cast<std::uint64_t>(count)};
+  for (int a = first; a < last && needed > 0; ++a) {
+    for (int b = a + 1; b < last && needed > 0; ++b) {
+      if (edgeSet.contains(a, b)) {
+        continue;
+      }
+      if (rng.below(remaining) < needed) {
+        edgeSet.insert(a, b);
+        edges.push_back({a, b});
+        --needed;
+      }
+      --remaining;
+    }
+  }
+}
+
+void erdosRenyiGnp(int first, int last, double probability,
+                   std::vector<Edge> &edges, CounterRng &rng) {
+  if (probability <= 0.0 || last - first < 2)
+    return;
+  probability = limitProbability(maxEdgeCount(last - first), probability);
+  reserveExpected(edges, maxEdgeCount(last - first), probability);
+
+  // Percorre os pares (v, w), w < v, em ordem lexicográfica, saltando
+  // diretamente para o próximo par incluído (Batagelj e Brandes, 2005)
+  GeometricSkip nextSkip{probability};
+  auto const n{static_cast<std::int64_t>(last - first)};
+  std::int64_t v{1};
+  std::int64_t w{-1};
+  while (v < n) {
+    w += nextSkip(rng);
+    while (w >= v && v < n) {
+      w -= v;
+      ++v;
+    }
+    if (v < n) {
+      edges.push_back(
+          {first + static_cast<int>(v), first + static_cast<int>(w)});
+    }
+  }
+}
+
+void bipartiteGnp(int firstA, int lastA, int firstB, int lastB,
+                  double probability, std::vector<Edge> &edges,
+                  CounterRng &rng) {
+  auto const sizeA{static_cast<std::int64_t>(lastA - firstA)};
+  auto const sizeB{static_cast<std::int64_t>(lastB - firstB)};
+  if (probability <= 0.0 || sizeA <= 0 || sizeB <= 0)
+    return;
+  probability = limitProbability(sizeA * sizeB, probability);
+  reserveExpected(edges, sizeA * sizeB, probability);
+
+  // Mesmo salto geométrico, agora sobre a grade retangular sizeA x sizeB
+  GeometricSkip nextSkip{probability};
+  std::int64_t a{0};
+  std::int64_t b{-1};
+  while (a < sizeA) {
+    b += nextSkip(rng);
+    if (b >= sizeB) {
+      a += b / sizeB;
+      b %= sizeB;
+    }
+    if (a < sizeA) {
+      edges.push_back(
+          {firstA + static_cast<int>(a), firstB + static_cast<int>(b)});
+    }
+  }
+}
+
+void erdosRenyiGnm(int numNodes, std::int64_t count, std::vector<Edge> &edges,
+                   CounterRng &rng) {
+  EdgeSet edgeSet;
+  sampleUniqueEdges(0, numNodes, count, 0, edgeSet, edges, rng);
+}
+
+void stochasticBlockModel(int numNodes, int numBlocks, double probabilityIn,
+                          double probabilityOut, std::uint64_t seed,
+                          int numThreads, std::vector<Edge> &edges) {
+  numBlocks = std::clamp(numBlocks, 1, std::max(numNodes, 1));
+  auto const expected{expectedBlockModelEdges(numNodes, numBlocks,
+                                              probabilityIn, probabilityOut)};
+  if (expected > static_cast<double>(maxExpectedEdges)) {
+    auto const scale{static_cast<double>(maxExpectedEdges) / expected};
+    probabilityIn *= scale;
+    probabilityOut *= scale;
+  }
+
+  // Início do bloco i: i * n / k (tamanhos diferem em no máximo um nó)
+  auto const blockStart{[&](int block) {
+    return static_cast<int>(static_cast<std::int64_t>(block) * numNodes /
+                            numBlocks);
+  }};
+
+  // Pares de blocos (i, j), j >= i, em ordem lexicográfica
+  std::vector<std::pair<int, int>> blockPairs;
+  for (int i = 0; i < numBlocks; ++i) {
+    for (int j = i; j < numBlocks; ++j) {
+      blockPairs.emplace_back(i, j);
+    }
+  }
+
+  std::vector<std::vector<Edge>> pairEdges(blockPairs.size());
+  parallelChunks(
+      blockPairs.size(), blockPairs.size(), numThreads,
+      [&](std::size_t pair, std::size_t, std::size_t) {
+        CounterRng rng{seed, pair};
+        auto const [i, j]{blockPairs[pair]};
+        if (i == j) {
+          erdosRenyiGnp(blockStart(i), blockStart(i + 1), probabilityIn,
+                        pairEdges[pair], rng);
+        } else {
+          bipartiteGnp(blockStart(i), blockStart(i + 1), blockStart(j),
+                       blockStart(j + 1), probabilityOut, pairEdges[pair], rng);
+        }
+      });
+
+  std::size_t total{edges.size()};
+  for (auto const &pairEdge : pairEdges) {
+    total += pairEdge.size();
+  }
+  edges.reserve(total);
+  for (auto &pairEdge : pairEdges) {
+    edges.insert(edges.end(), pairEdge.begin(), pairEdge.end());
+    std::vector<Edge>().swap(pairEdge);
+  }
+}
+
+void barabasiAlbertParallel(int numNodes, int edgesPerNode,
+                            std::uint64_t seed, int numThreads,
+                            std::vector<Edge> &edges) {
+  if (numNodes < 2 || edgesPerNode < 1)
+    return;
+
+  PreferentialAttachment model{edgesPerNode, seed};
+  auto const m{static_cast<std::size_t>(edgesPerNode)};
+  auto const first{edges.size()};
+  edges.resize(first + static_cast<std::size_t>(numNodes - 1) * m);
+
+  // Cada bloco de nós grava as suas arestas a partir do início da sua faixa
+  // e registra quantas gravou; depois as faixas são compactadas em ordem
+  auto const numChunks{std::max<std::size_t>(
+      1, static_cast<std::size_t>(numThreads) * 16)};
+  std::vector<std::size_t> chunkCounts(numChunks);
+  parallelChunks(
+      static_cast<std::size_t>(numNodes - 1), numChunks, numThreads,
+      [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        auto *const start{edges.data() + first + begin * m};
+        auto *out{start};
+        for (auto i{begin}; i < end; ++i) {
+          out += model.emitNode(
+              static_cast<int>(i + 1),
+              [&](std::uint64_t e) { return model.target(e); }, out);
+        }
+        chunkCounts[chunk] = static_cast<std::size_t>(out - start);
+      });
+
+  auto *out{edges.data() + first};
+  for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+    auto const begin{static_cast<std::size_t>(numNodes - 1) * chunk /
+                     numChunks};
+    auto const *const start{edges.data() + first + begin * m};
+    // O primeiro bloco (e os seguintes, enquanto nenhum descartou arestas)
+    // já está no lugar; std::copy não aceita destino igual à origem
+    if (out != start) {
+      std::copy(start, start + chunkCounts[chunk], out);
+    }
+    out += chunkCounts[chunk];
+  }
+  edges.resize(static_cast<std::size_t>(out - edges.data()));
+}
+
+namespace {
+// Blocos das etapas paralelas do R-MAT
+std::size_t rmatChunks(int numThreads) {
+  return std::max<std::size_t>(1, static_cast<std::size_t>(numThreads) * 16);
+}
+
+// Cada sorteio vira a chave (min << scale) | max. Como min < max, a chave
+// com todos os 2 * scale bits em 1 nunca é válida e marca os laços
+std::uint64_t rmatLoopKey(int scale) {
+  return (std::uint64_t{1} << (2 * scale)) - 1;
+}
+
+// Chaves dos edgeFactor * 2^scale sorteios, ordenadas; os laços ficam no fim
+std::vector<std::uint64_t> rmatKeys(int scale, int edgeFactor,
+                                    RMatParameters const &parameters,
+                                    std::uint64_t seed, int numThreads) {
+  auto const numSamples{(std::size_t{1} << scale) *
+                        static_cast<std::size_t>(edgeFactor)};
+  // Limiares acumulados a, a + b e a + b + c em ponto fixo de 32 bits: cada
+  // nível consome metade de um número de 64 bits
+  auto const threshold{[](double p) {
+    return static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0) * 0x1.0p32);
+  }};
+  double const a{parameters.a};
+  double const b{parameters.b};
+  double const c{parameters.c};
+  auto const ta{threshold(a)};
+  auto const tab{threshold(a + b)};
+  auto const tabc{threshold(a + b + c)};
+
+  auto const loopKey{rmatLoopKey(scale)};
+  std::vector<std::uint64_t> keys(numSamples);
+  parallelChunks(
+      numSamples, rmatChunks(numThreads), numThreads,
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto e{begin}; e < end; ++e) {
+          CounterRng stream{seed, e};
+          std::uint64_t bits{};
+          std::uint64_t row{0};
+          std::uint64_t column{0};
+          for (int level = 0; level < scale; ++level) {
+            if (level % 2 == 0) {
+              bits = stream();
+            }
+            auto const u{bits & 0xFFFFFFFFULL};
+            bits >>= 32U;
+            // Quadrante a (0, 0), b (0, 1), c (1, 0) ou d (1, 1)
+            auto const quadrant{static_cast<std::uint64_t>(u >= ta) +
+                                static_cast<std::uint64_t>(u >= tab) +
+                                static_cast<std::uint64_t>(u >= tabc)};
+            row = (row << 1U) | (quadrant >> 1U);
+            column = (column << 1U) | (quadrant & 1U);
+          }
+          keys[e] = row == column ? loopKey
+                                  : (std::min(row, column) << scale) |
+                                        std::max(row, column);
+        }
+      });
+
+  // As chaves ocupam 2 * scale bits; laços ficam no fim após a ordenação
+  parallelRadixSort(keys, 2 * scale, numThreads);
+  return keys;
+}
+
+// A chave i é a primeira ocorrência de uma aresta
+bool isNewKey(std::span<std::uint64_t const> keys, std::size_t i,
+              std::uint64_t loopKey) {
+  return keys[i] != loopKey && (i == 0 || keys[i] != keys[i - 1]);
+}
+
+// Posição, na saída, da primeira aresta de cada bloco de `keys`; o último
+// valor é o número de arestas
+std::vector<std::size_t> distinctKeyOffsets(std::span<std::uint64_t const> keys,
+                                            std::uint64_t loopKey,
+                                            std::size_t numChunks,
+                                            int numThreads) {
+  std::vector<std::size_t> chunkStart(numChunks + 1, 0);
+  parallelChunks(keys.size(), numChunks, numThreads,
+                 [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                   std::size_t count{0};
+                   for (auto i{begin}; i < end; ++i) {
+                     count += isNewKey(keys, i, loopKey) ? 1 : 0;
+                   }
+                   chunkStart[chunk + 1] = count;
+                 });
+  for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+    chunkStart[chunk + 1] += chunkStart[chunk];
+  }
+  return chunkStart;
+}
+} // namespace
+
+void rmat(int scale, int edgeFactor, RMatParameters const &parameters,
+          std::uint64_t seed, int numThreads, std::vector<Edge> &edges) {
+  if (scale < 1 || edgeFactor < 1)
+    return;
+
+  auto const keys{rmatKeys(scale, edgeFactor, parameters, seed, numThreads)};
+
+  // Compactação das chaves distintas: cada bloco conta as suas chaves novas,
+  // os blocos recebem as suas posições de saída e gravam em paralelo
+  auto const loopKey{rmatLoopKey(scale)};
+  auto const numChunks{rmatChunks(numThreads)};
+  auto const chunkStart{
+      distinctKeyOffsets(keys, loopKey, numChunks, numThreads)};
+
+  auto const first{edges.size()};
+  edges.resize(first + chunkStart[numChunks]);
+  auto const mask{(std::uint64_t{1} << scale) - 1};
+  parallelChunks(keys.size(), numChunks, numThreads,
+                 [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                   auto *out{edges.data() + first + chunkStart[chunk]};
+                   for (auto i{begin}; i < end; ++i) {
+                     if (isNewKey(keys, i, loopKey)) {
+                       *out++ = {static_cast<int>(keys[i] >> scale),
+                                 static_cast<int>(keys[i] & mask)};
+                     }
+                   }
+                 });
+}
+
+namespace {
+// Maior escala, até 30, em que os sorteios cabem em maxRMatBytes
+int maxRMatScaleFor(int edgeFactor, std::uint64_t bytesPerSample) {
+  auto const bytesPerNode{bytesPerSample *
+                          static_cast<std::uint64_t>(std::max(edgeFactor, 1))};
+  int scale{1};
+  while (scale < 30 &&
+         (std::uint64_t{2} << scale) * bytesPerNode <= maxRMatBytes) {
+    ++scale;
+  }
+  return scale;
+}
+} // namespace
+
+int maxRMatScale(int edgeFactor) {
+  return maxRMatScaleFor(edgeFactor,
+                         2 * sizeof(std::uint64_t) + sizeof(Edge));
+}
+
+int maxRMatFileScale(int edgeFactor) {
+  return maxRMatScaleFor(edgeFactor, 2 * sizeof(std::uint64_t));
+}
+
+namespace {
+// Grava o cabeçalho e as arestas de writeRMat em `file` e retorna o número
+// de arestas
+std::size_t writeRMatEdges(std::ofstream &file, int scale, int edgeFactor,
+                           RMatParameters const &parameters,
+                           std::uint64_t seed, int numThreads) {
+  auto const keys{rmatKeys(scale, edgeFactor, parameters, seed, numThreads)};
+  auto const loopKey{rmatLoopKey(scale)};
+  auto const numEdges{distinctKeyOffsets(keys, loopKey,
+                                        rmatChunks(numThreads), numThreads)
+                           .back()};
+
+  std::array const header{std::uint64_t{1} << scale,
+                          static_cast<std::uint64_t>(numEdges)};
+  file.write(reinterpret_cast<char const *>(header.data()), sizeof(header));
+
+  // As arestas saem das chaves ordenadas em blocos de writeChunkSize, sem
+  // uma segunda cópia do grafo inteiro
+  constexpr std::size_t writeChunkSize{std::size_t{1} << 20};
+  static_assert(sizeof(Edge) == 2 * sizeof(std::int32_t));
+  std::vector<Edge> chunk;
+  chunk.reserve(writeChunkSize);
+  auto const flush{[&] {
+    file.write(reinterpret_cast<char const *>(chunk.data()),
+               static_cast<std::streamsize>(chunk.size() * sizeof(Edge)));
+    chunk.clear();
+  }};
+  auto const mask{(std::uint64_t{1} << scale) - 1};
+  for (std::size_t i = 0; i < keys.size() && file; ++i) {
+    if (isNewKey(keys, i, loopKey)) {
+      chunk.push_back({static_cast<int>(keys[i] >> scale),
+                       static_cast<int>(keys[i] & mask)});
+      if (chunk.size() == writeChunkSize) {
+        flush();
+      }
+    }
+  }
+  flush();
+  return numEdges;
+}
+} // namespace
+
+bool writeRMat(std::string const &path, int scale, int edgeFactor,
+               RMatParameters const &parameters, std::uint64_t seed,
+               int numThreads, std::size_t &numEdges) {
+  numEdges = 0;
+  if (scale < 1 || edgeFactor < 1)
+    return false;
+
+  // As arestas vão para um arquivo temporário, que só substitui `path`
+  // depois de gravado por inteiro: uma falha, inclusive de memória, preserva
+  // o arquivo anterior
+  auto const temporaryPath{path + ".tmp"};
+  std::ofstream file{temporaryPath, std::ios::binary};
+  if (!file)
+    return false;
+  auto const discard{[&] {
+    file.close();
+    std::error_code error;
+    std::filesystem::remove(temporaryPath, error);
+  }};
+
+  try {
+    numEdges = writeRMatEdges(file, scale, edgeFactor, parameters, seed,
+                              numThreads);
+  } catch (...) {
+    discard();
+    throw;
+  }
+  file.close();
+
+  std::error_code error;
+  if (file) {
+    std::filesystem::rename(temporaryPath, path, error);
+  }
+  if (!file || error) {
+    discard();
+    numEdges = 0;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,137 @@
+// generators.hpp
+
+#ifndef GENERATORS_HPP_
+#define GENERATORS_HPP_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "csrgraph.hpp"
+#include "edgeset.hpp"
+#include "rng.hpp"
+
+// Número de pares não ordenados de nós distintos entre `numNodes` nós
+std::int64_t maxEdgeCount(int numNodes);
+
+// Máximo de arestas esperadas dos modelos com probabilidade por par (G(n, p),
+// bipartido e SBM) e de arestas pedidas a sampleUniqueEdges (G(n, m) e o
+// modelo padrão): 2^27 arestas ocupam 1 GB, mais a CSR. Acima disso as
+// probabilidades e os totais são reduzidos, em vez de esgotar a memória
+inline constexpr std::int64_t maxExpectedEdges{std::int64_t{1} << 27};
+
+// Maior probabilidade, até `probability`, com no máximo maxExpectedEdges
+// arestas esperadas entre `pairs` pares
+double limitProbability(std::int64_t pairs, double probability);
+
+// Arestas esperadas do SBM com os parâmetros de stochasticBlockModel
+double expectedBlockModelEdges(int numNodes, int numBlocks,
+                               double probabilityIn, double probabilityOut);
+
+// Acrescenta a `edges` exatamente `count` arestas distintas, sorteadas
+// uniformemente entre os pares de nós de [first, last) que ainda não estão em
+// `edgeSet` (`existing` é quantas arestas de `edgeSet` já ligam nós desse
+// intervalo). `count` é limitado ao número de pares livres e a
+// maxExpectedEdges. Custo esperado O(count): em grafos esparsos cada sorteio
+// é aceito com probabilidade >= 1/2; quando mais da metade dos pares livres é
+// pedida, os pares livres (menos de 2 * count) são percorridos em ordem e
+// cada um é escolhido com probabilidade (faltantes) / (restantes), a
+// amostragem seletiva de Knuth, sem guardar os pares livres
+void sampleUniqueEdges(int first, int last, std::int64_t count,
+                       std::int64_t existing, EdgeSet &edgeSet,
+                       std::vector<Edge> &edges, CounterRng &rng);
+
+// Erdős–Rényi G(n, p) sobre os nós de [first, last): cada par é incluído
+// independentemente com probabilidade p. Usa o salto geométrico de Batagelj e
+// Brandes, sorteando diretamente a distância até o próximo par incluído, de
+// modo que o custo é O(n + m) em vez de O(n²) sorteios. p é limitado por
+// limitProbability
+void erdosRenyiGnp(int first, int last, double probability,
+                   std::vector<Edge> &edges, CounterRng &rng);
+
+// Variante bipartida de G(n, p): cada par (a, b) com a em [firstA, lastA) e b
+// em [firstB, lastB) é incluído com probabilidade p. Os intervalos devem ser
+// disjuntos. p é limitado por limitProbability
+void bipartiteGnp(int firstA, int lastA, int firstB, int lastB,
+                  double probability, std::vector<Edge> &edges,
+                  CounterRng &rng);
+
+// Erdős–Rényi G(n, m): exatamente m arestas distintas, uniformes entre todos
+// os pares de [0, numNodes)
+void erdosRenyiGnm(int numNodes, std::int64_t count, std::vector<Edge> &edges,
+                   CounterRng &rng);
+
+// Modelo de blocos estocásticos (SBM): os nós são divididos em `numBlocks`
+// blocos consecutivos de tamanhos aproximadamente iguais; pares dentro de um
+// mesmo bloco são ligados com probabilidade `probabilityIn` e pares entre
+// blocos distintos com `probabilityOut`. Cada par de blocos reutiliza o salto
+// geométrico de G(n, p) com o seu próprio fluxo de `seed`; os pares são
+// distribuídos entre `numThreads` threads e as arestas concatenadas na ordem
+// dos pares, então o resultado não depende do número de threads. Com dois
+// blocos e probabilityOut = 0 corresponde ao grafo desconexo de dois grupos.
+// Se o total esperado passa de maxExpectedEdges, as duas probabilidades são
+// reduzidas na mesma proporção
+void stochasticBlockModel(int numNodes, int numBlocks, double probabilityIn,
+                          double probabilityOut, std::uint64_t seed,
+                          int numThreads, std::vector<Edge> &edges);
+
+// Barabási–Albert (ligação preferencial): cada nó v >= 1 liga-se a até
+// `edgesPerNode` nós anteriores escolhidos com probabilidade proporcional ao
+// grau. Usa o vetor de extremidades repetidas de Batagelj e Brandes: as
+// extremidades de todas as arestas são gravadas em sequência e sortear uma
+// posição uniforme desse vetor equivale a sortear um nó proporcionalmente ao
+// grau. Arestas repetidas de um mesmo nó são descartadas.
+//
+// Versão paralela de Sanders e Schulz (2016): a posição sorteada para cada
+// aresta é uma função hash de (seed, aresta), e a extremidade guardada em
+// uma posição ímpar é resolvida recursivamente em vez de lida do vetor, que
+// não chega a ser gravado. Cada aresta pode então ser calculada de forma
+// independente, e o resultado é o mesmo para a mesma semente, qualquer que
+// seja o número de threads
+void barabasiAlbertParallel(int numNodes, int edgesPerNode,
+                            std::uint64_t seed, int numThreads,
+                            std::vector<Edge> &edges);
+
+// Probabilidades dos quadrantes do R-MAT; d = 1 - a - b - c. Os valores
+// padrão são os do benchmark Graph500
+struct RMatParameters {
+  float a{0.57f};
+  float b{0.19f};
+  float c{0.19f};
+};
+
+// R-MAT (Chakrabarti, Zhan e Faloutsos, 2004): gera 2^scale nós e
+// edgeFactor * 2^scale sorteios de arestas descendo recursivamente pelos
+// quadrantes da matriz de adjacência. Cada aresta usa apenas números
+// derivados de (seed, aresta, nível), de modo que as arestas são geradas em
+// paralelo sem estado compartilhado. Laços são descartados e duplicatas são
+// removidas ordenando as chaves das arestas com um radix sort paralelo. O
+// resultado, ordenado por (nodeA, nodeB) com nodeA < nodeB, não depende do
+// número de threads
+void rmat(int scale, int edgeFactor, RMatParameters const &parameters,
+          std::uint64_t seed, int numThreads, std::vector<Edge> &edges);
+
+// Memória máxima de rmat e writeRMat (4 GB)
+inline constexpr std::uint64_t maxRMatBytes{std::uint64_t{1} << 32};
+
+// Maior escala de rmat com `edgeFactor` dentro de maxRMatBytes: cada sorteio
+// ocupa 24 bytes (a chave, o buffer do radix sort e a aresta no vetor de
+// saída, ainda com a capacidade do grafo anterior)
+int maxRMatScale(int edgeFactor);
+
+// Maior escala de writeRMat com `edgeFactor` dentro de maxRMatBytes: cada
+// sorteio ocupa 16 bytes (a chave e o buffer do radix sort)
+int maxRMatFileScale(int edgeFactor);
+
+// Gera o mesmo grafo de rmat e grava as arestas em um arquivo binário:
+// número de nós e número de arestas (uint64) seguidos de um par de int32 por
+// aresta, na ordem de bytes nativa. As arestas são gravadas em blocos,
+// direto das chaves ordenadas, sem o vetor de arestas, em `path` + ".tmp",
+// que só substitui `path` depois de completo. Retorna false se o arquivo não
+// puder ser gravado; `numEdges` recebe o número de arestas
+bool writeRMat(std::string const &path, int scale, int edgeFactor,
+               RMatParameters const &parameters, std::uint64_t seed,
+               int numThreads, std::size_t &numEdges);
+
+#endif
@@ -0,0 +1,136 @@
+// glyphatlas.cpp
+
+#include "glyphatlas.hpp"
+
+#include <algorithm>
+#include <bit>
+
+// A ImGui compila a sua cópia da stb_truetype com ligação interna; esta é
+// uma segunda cópia, também interna a esta unidade de tradução. As funções
+// que não são usadas aqui gerariam avisos de -Wunused-function
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <imstb_truetype.h>
+#pragma GCC diagnostic pop
+
+bool GlyphAtlas::build(std::span<unsigned char const> ttf, int pixelHeight,
+                       int padding) {
+  stbtt_fontinfo font;
+  if (stbtt_InitFont(&font, ttf.data(),
+                     stbtt_GetFontOffsetForIndex(ttf.data(), 0)) == 0)
+    return false;
+
+  auto const scale{stbtt_ScaleForPixelHeight(&font,
+                                             static_cast<float>(pixelHeight))};
+  int ascent{};
+  int descent{};
+  int lineGap{};
+  stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
+  auto const lineHeight{static_cast<float>(pixelHeight)};
+  m_baseline =
+      -static_cast<float>(ascent + descent) * scale / 2.0f / lineHeight;
+
+  // Cada unidade de distância (em pixels do SDF) vale 128 / padding níveis,
+  // então o campo cobre `padding` pixels para fora do contorno
+  constexpr unsigned char onEdge{128};
+  auto const distanceScale{static_cast<float>(onEdge) /
+                           static_cast<float>(padding)};
+
+  struct Bitmap {
+    unsigned char *data;
+    int width;
+    int height;
+  };
+  std::vector<Bitmap> bitmaps;
+  bitmaps.reserve(m_glyphs.size());
+
+  // Empacotamento em prateleiras: os glifos de uma fonte monoespaçada têm
+  // alturas parecidas, então linhas de altura fixa desperdiçam pouco espaço
+  constexpr int atlasWidth{512};
+  int x{0};
+  int y{0};
+  int shelfHeight{0};
+  std::vector<glm::ivec2> origins;
+  origins.reserve(m_glyphs.size());
+
+  for (auto c{m_firstChar}; c <= m_lastChar; ++c) {
+    auto &glyph{m_glyphs[static_cast<std::size_t>(c - m_firstChar)]};
+
+    int advance{};
+    int leftSideBearing{};
+    stbtt_GetCodepointHMetrics(&font, c, &advance, &leftSideBearing);
+    glyph.advance = static_cast<float>(advance) * scale / lineHeight;
+
+    Bitmap bitmap{};
+    int xOffset{};
+    int yOffset{};
+    bitmap.data = stbtt_GetCodepointSDF(&font, scale, c, padding, onEdge,
+                                        distanceScale, &bitmap.width,
+                                        &bitmap.height, &xOffset, &yOffset);
+    if (bitmap.data == nullptr) {
+      bitmap = {};
+    }
+
+    if (x + bitmap.width > atlasWidth) {
+      x = 0;
+      y += shelfHeight + 1;
+      shelfHeight = 0;
+    }
+    origins.push_back({x, y});
+    x += bitmap.width + 1;
+    shelfHeight = std::max(shelfHeight, bitmap.height);
+
+    // O bitmap tem y para baixo a partir do topo (yOffset); as métricas do
+    // atlas têm y para cima a partir da linha de base
+    glyph.offset = glm::vec2{static_cast<float>(xOffset),
+                             -static_cast<float>(yOffset + bitmap.height)} /
+                   lineHeight;
+    glyph.size =
+        glm::vec2{static_cast<float>(bitmap.width),
+                  static_cast<float>(bitmap.height)} /
+        lineHeight;
+    bitmaps.push_back(bitmap);
+  }
+
+  // Altura em potência de dois, para compatibilidade com WebGL
+  m_width = atlasWidth;
+  m_height = static_cast<int>(
+      std::bit_ceil(static_cast<unsigned>(y + shelfHeight)));
+  m_pixels.assign(static_cast<std::size_t>(m_width * m_height), 0);
+
+  auto const texelWidth{1.0f / static_cast<float>(m_width)};
+  auto const texelHeight{1.0f / static_cast<float>(m_height)};
+  for (std::size_t i = 0; i < bitmaps.size(); ++i) {
+    auto const &bitmap{bitmaps[i]};
+    auto const origin{origins[i]};
+    for (int row = 0; row < bitmap.height; ++row) {
+      std::copy_n(bitmap.data + row * bitmap.width, bitmap.width,
+                  m_pixels.begin() + (origin.y + row) * m_width + origin.x);
+    }
+    m_glyphs[i].texRect = {
+        static_cast<float>(origin.x) * texelWidth,
+        static_cast<float>(origin.y) * texelHeight,
+        static_cast<float>(origin.x + bitmap.width) * texelWidth,
+        static_cast<float>(origin.y + bitmap.height) * texelHeight};
+    stbtt_FreeSDF(bitmap.data, nullptr);
+  }
+
+  return true;
+}
+
+GlyphAtlas::Glyph const &GlyphAtlas::glyph(char c) const {
+  if (c < m_firstChar || c > m_lastChar) {
+    c = '?';
+  }
+  return m_glyphs[static_cast<std::size_t>(c - m_firstChar)];
+}
+
+float GlyphAtlas::textWidth(std::string_view text) const {
+  float width{0.0f};
+  for (auto c : text) {
+    width += glyph(c).advance;
+  }
+  return width;
+}
@@ -0,0 +1,61 @@
+// glyphatlas.hpp
+
+#ifndef GLYPHATLAS_HPP_
+#define GLYPHATLAS_HPP_
+
+#include <array>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Atlas de campos de distância com sinal (SDF) dos caracteres ASCII
+// imprimíveis de uma fonte TrueType. Cada texel guarda a distância até o
+// contorno do glifo (0,5 sobre o contorno, maior dentro), de modo que um único
+// atlas pequeno, amostrado com filtragem linear, produz bordas nítidas em
+// qualquer escala. As métricas são dadas em unidades da altura da linha
+// (ascendente menos descendente), com o eixo y para cima
+class GlyphAtlas {
+public:
+  struct Glyph {
+    glm::vec2 offset{};  // Canto inferior esquerdo, relativo à origem
+    glm::vec2 size{};    // Largura e altura (zero para glifos vazios)
+    glm::vec4 texRect{}; // (u0, v0, u1, v1), com v0 no topo do glifo
+    float advance{};     // Avanço horizontal até o próximo glifo
+  };
+
+  // Gera os glifos com `pixelHeight` pixels de altura de linha e `padding`
+  // pixels de campo de distância ao redor de cada um. Retorna false se a
+  // fonte não puder ser lida
+  bool build(std::span<unsigned char const> ttf, int pixelHeight = 32,
+             int padding = 4);
+
+  // Glifo do caractere, ou do '?' para caracteres fora do atlas
+  [[nodiscard]] Glyph const &glyph(char c) const;
+
+  // Linha de base relativa ao centro vertical da linha
+  [[nodiscard]] float baseline() const { return m_baseline; }
+
+  // Largura total de um texto, somando os avanços
+  [[nodiscard]] float textWidth(std::string_view text) const;
+
+  [[nodiscard]] int width() const { return m_width; }
+  [[nodiscard]] int height() const { return m_height; }
+  [[nodiscard]] std::span<std::uint8_t const> pixels() const {
+    return m_pixels;
+  }
+
+private:
+  static constexpr char m_firstChar{' '};
+  static constexpr char m_lastChar{'~'};
+
+  std::array<Glyph, m_lastChar - m_firstChar + 1> m_glyphs{};
+  float m_baseline{};
+  int m_width{};
+  int m_height{};
+  std::vector<std::uint8_t> m_pixels; // Um canal, linhas de cima para baixo
+};
+
+#endif
@@ -0,0 +1,308 @@
+// layoutkernels.cpp
+
+#include "layoutkernels.hpp"
+
+#include <array>
+#include <glm/geometric.hpp>
+
+#if !defined(__EMSCRIPTEN__) &&                                                \
+    (defined(__x86_64__) || defined(__i386__) || defined(_M_X64))
+#define LAYOUT_KERNELS_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// O MSVC aceita intrínsecas AVX2 sem /arch:AVX2
+#define LAYOUT_TARGET_AVX2
+#else
+// Apenas estas funções usam AVX2 e FMA; o restante do programa continua
+// executável em qualquer processador x86-64
+#define LAYOUT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LAYOUT_KERNELS_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define LAYOUT_KERNELS_SIMD128
+#include <wasm_simd128.h>
+#endif
+
+namespace {
+// Versões escalares, também usadas para os elementos que sobram depois dos
+// blocos completos das versões SIMD
+glm::vec2 repulsionRange(glm::vec2 point, float const *x, float const *y,
+                         float const *mass, std::size_t begin,
+                         std::size_t end) {
+  glm::vec2 sum{};
+  for (auto j{begin}; j < end; ++j) {
+    glm::vec2 const delta{point.x - x[j], point.y - y[j]};
+    auto const distance2{glm::dot(delta, delta)};
+    if (distance2 > 0.0f) {
+      sum += delta * (mass[j] / distance2);
+    }
+  }
+  return sum;
+}
+
+glm::vec2 attractionRange(glm::vec2 point, float const *x, float const *y,
+                          int const *neighbors, std::size_t begin,
+                          std::size_t end) {
+  glm::vec2 sum{};
+  for (auto j{begin}; j < end; ++j) {
+    auto const neighbor{static_cast<std::size_t>(neighbors[j])};
+    glm::vec2 const delta{x[neighbor] - point.x, y[neighbor] - point.y};
+    sum += delta * glm::length(delta);
+  }
+  return sum;
+}
+
+glm::vec2 repulsionScalar(glm::vec2 point, float const *x, float const *y,
+                          float const *mass, std::size_t count,
+                          float strength) {
+  return strength * repulsionRange(point, x, y, mass, 0, count);
+}
+
+glm::vec2 attractionScalar(glm::vec2 point, float const *x, float const *y,
+                           int const *neighbors, std::size_t count) {
+  return attractionRange(point, x, y, neighbors, 0, count);
+}
+
+#if defined(LAYOUT_KERNELS_AVX2)
+bool supportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  // AVX2 (CPUID 7, EBX bit 5), FMA e AVX (CPUID 1, ECX bits 12 e 28), com
+  // os registradores YMM habilitados pelo sistema operacional (XCR0)
+  std::array<int, 4> info{};
+  __cpuid(info.data(), 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info.data(), 1);
+  constexpr int fmaBit{1 << 12};
+  constexpr int osxsaveBit{1 << 27};
+  constexpr int avxBit{1 << 28};
+  if ((info[2] & (fmaBit | osxsaveBit | avxBit)) !=
+          (fmaBit | osxsaveBit | avxBit) ||
+      (_xgetbv(0) & 6U) != 6U) {
+    return false;
+  }
+  __cpuidex(info.data(), 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+LAYOUT_TARGET_AVX2 float sumLanes(__m256 value) {
+  auto const half{_mm_add_ps(_mm256_castps256_ps128(value),
+                             _mm256_extractf128_ps(value, 1))};
+  auto const pairs{_mm_add_ps(half, _mm_movehl_ps(half, half))};
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehdup_ps(pairs)));
+}
+
+LAYOUT_TARGET_AVX2 glm::vec2 repulsionAvx2(glm::vec2 point, float const *x,
+                                           float const *y, float const *mass,
+                                           std::size_t count,
+                                           float strength) {
+  auto const pointX{_mm256_set1_ps(point.x)};
+  auto const pointY{_mm256_set1_ps(point.y)};
+  auto const zero{_mm256_setzero_ps()};
+  auto sumX{zero};
+  auto sumY{zero};
+
+  std::size_t j{0};
+  for (; j + 8 <= count; j += 8) {
+    auto const deltaX{_mm256_sub_ps(pointX, _mm256_loadu_ps(x + j))};
+    auto const deltaY{_mm256_sub_ps(pointY, _mm256_loadu_ps(y + j))};
+    auto const distance2{
+        _mm256_fmadd_ps(deltaX, deltaX, _mm256_mul_ps(deltaY, deltaY))};
+    // Fontes coincidentes dividem por zero e são zeradas pela máscara
+    auto const scale{
+        _mm256_and_ps(_mm256_div_ps(_mm256_loadu_ps(mass + j), distance2),
+                      _mm256_cmp_ps(distance2, zero, _CMP_GT_OQ))};
+    sumX = _mm256_fmadd_ps(deltaX, scale, sumX);
+    sumY = _mm256_fmadd_ps(deltaY, scale, sumY);
+  }
+
+  glm::vec2 const sum{sumLanes(sumX), sumLanes(sumY)};
+  // Zera a metade superior dos registradores YMM antes de voltar a código
+  // SSE: sem isso cada instrução SSE seguinte paga uma dependência falsa com
+  // os bits altos, o que deixa o programa inteiro mais lento
+  _mm256_zeroupper();
+  return strength * (sum + repulsionRange(point, x, y, mass, j, count));
+}
+
+LAYOUT_TARGET_AVX2 glm::vec2 attractionAvx2(glm::vec2 point, float const *x,
+                                            float const *y,
+                                            int const *neighbors,
+                                            std::size_t count) {
+  auto const pointX{_mm256_set1_ps(point.x)};
+  auto const pointY{_mm256_set1_ps(point.y)};
+  auto sumX{_mm256_setzero_ps()};
+  auto sumY{_mm256_setzero_ps()};
+
+  std::size_t j{0};
+  for (; j + 8 <= count; j += 8) {
+    auto const index{_mm256_loadu_si256(
+        reinterpret_cast<__m256i const *>(neighbors + j))};
+    auto const deltaX{
+        _mm256_sub_ps(_mm256_i32gather_ps(x, index, 4), pointX)};
+    auto const deltaY{
+        _mm256_sub_ps(_mm256_i32gather_ps(y, index, 4), pointY)};
+    auto const length{_mm256_sqrt_ps(
+        _mm256_fmadd_ps(deltaX, deltaX, _mm256_mul_ps(deltaY, deltaY)))};
+    sumX = _mm256_fmadd_ps(deltaX, length, sumX);
+    sumY = _mm256_fmadd_ps(deltaY, length, sumY);
+  }
+
+  glm::vec2 const sum{sumLanes(sumX), sumLanes(sumY)};
+  _mm256_zeroupper();
+  return sum + attractionRange(point, x, y, neighbors, j, count);
+}
+#endif
+
+#if defined(LAYOUT_KERNELS_NEON)
+glm::vec2 repulsionNeon(glm::vec2 point, float const *x, float const *y,
+                        float const *mass, std::size_t count,
+                        float strength) {
+  auto const pointX{vdupq_n_f32(point.x)};
+  auto const pointY{vdupq_n_f32(point.y)};
+  auto const zero{vdupq_n_f32(0.0f)};
+  auto sumX{zero};
+  auto sumY{zero};
+
+  std::size_t j{0};
+  for (; j + 4 <= count; j += 4) {
+    auto const deltaX{vsubq_f32(pointX, vld1q_f32(x + j))};
+    auto const deltaY{vsubq_f32(pointY, vld1q_f32(y + j))};
+    auto const distance2{
+        vfmaq_f32(vmulq_f32(deltaY, deltaY), deltaX, deltaX)};
+    auto const scale{vreinterpretq_f32_u32(
+        vandq_u32(vreinterpretq_u32_f32(
+                      vdivq_f32(vld1q_f32(mass + j), distance2)),
+                  vcgtq_f32(distance2, zero)))};
+    sumX = vfmaq_f32(sumX, deltaX, scale);
+    sumY = vfmaq_f32(sumY, deltaY, scale);
+  }
+
+  glm::vec2 const sum{vaddvq_f32(sumX), vaddvq_f32(sumY)};
+  return strength * (sum + repulsionRange(point, x, y, mass, j, count));
+}
+
+glm::vec2 attractionNeon(glm::vec2 point, float const *x, float const *y,
+                         int const *neighbors, std::size_t count) {
+  auto const pointX{vdupq_n_f32(point.x)};
+  auto const pointY{vdupq_n_f32(point.y)};
+  auto sumX{vdupq_n_f32(0.0f)};
+  auto sumY{vdupq_n_f32(0.0f)};
+
+  // O NEON não tem gather: as coordenadas dos vizinhos são lidas uma a uma
+  std::size_t j{0};
+  for (; j + 4 <= count; j += 4) {
+    std::array<float, 4> neighborX{};
+    std::array<float, 4> neighborY{};
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      auto const neighbor{static_cast<std::size_t>(neighbors[j + lane])};
+      neighborX[lane] = x[neighbor];
+      neighborY[lane] = y[neighbor];
+    }
+    auto const deltaX{vsubq_f32(vld1q_f32(neighborX.data()), pointX)};
+    auto const deltaY{vsubq_f32(vld1q_f32(neighborY.data()), pointY)};
+    auto const length{
+        vsqrtq_f32(vfmaq_f32(vmulq_f32(deltaY, deltaY), deltaX, deltaX))};
+    sumX = vfmaq_f32(sumX, deltaX, length);
+    sumY = vfmaq_f32(sumY, deltaY, length);
+  }
+
+  glm::vec2 const sum{vaddvq_f32(sumX), vaddvq_f32(sumY)};
+  return sum + attractionRange(point, x, y, neighbors, j, count);
+}
+#endif
+
+#if defined(LAYOUT_KERNELS_SIMD128)
+float sumLanes(v128_t value) {
+  return wasm_f32x4_extract_lane(value, 0) +
+         wasm_f32x4_extract_lane(value, 1) +
+         wasm_f32x4_extract_lane(value, 2) +
+         wasm_f32x4_extract_lane(value, 3);
+}
+
+glm::vec2 repulsionSimd128(glm::vec2 point, float const *x, float const *y,
+                           float const *mass, std::size_t count,
+                           float strength) {
+  auto const pointX{wasm_f32x4_splat(point.x)};
+  auto const pointY{wasm_f32x4_splat(point.y)};
+  auto const zero{wasm_f32x4_splat(0.0f)};
+  auto sumX{zero};
+  auto sumY{zero};
+
+  std::size_t j{0};
+  for (; j + 4 <= count; j += 4) {
+    auto const deltaX{wasm_f32x4_sub(pointX, wasm_v128_load(x + j))};
+    auto const deltaY{wasm_f32x4_sub(pointY, wasm_v128_load(y + j))};
+    auto const distance2{wasm_f32x4_add(wasm_f32x4_mul(deltaX, deltaX),
+                                        wasm_f32x4_mul(deltaY, deltaY))};
+    auto const scale{
+        wasm_v128_and(wasm_f32x4_div(wasm_v128_load(mass + j), distance2),
+                      wasm_f32x4_gt(distance2, zero))};
+    sumX = wasm_f32x4_add(sumX, wasm_f32x4_mul(deltaX, scale));
+    sumY = wasm_f32x4_add(sumY, wasm_f32x4_mul(deltaY, scale));
+  }
+
+  glm::vec2 const sum{sumLanes(sumX), sumLanes(sumY)};
+  return strength * (sum + repulsionRange(point, x, y, mass, j, count));
+}
+
+glm::vec2 attractionSimd128(glm::vec2 point, float const *x, float const *y,
+                            int const *neighbors, std::size_t count) {
+  auto const pointX{wasm_f32x4_splat(point.x)};
+  auto const pointY{wasm_f32x4_splat(point.y)};
+  auto sumX{wasm_f32x4_splat(0.0f)};
+  auto sumY{wasm_f32x4_splat(0.0f)};
+
+  std::size_t j{0};
+  for (; j + 4 <= count; j += 4) {
+    auto const *const index{neighbors + j};
+    auto const deltaX{wasm_f32x4_sub(
+        wasm_f32x4_make(x[index[0]], x[index[1]], x[index[2]], x[index[3]]),
+        pointX)};
+    auto const deltaY{wasm_f32x4_sub(
+        wasm_f32x4_make(y[index[0]], y[index[1]], y[index[2]], y[index[3]]),
+        pointY)};
+    auto const length{wasm_f32x4_sqrt(wasm_f32x4_add(
+        wasm_f32x4_mul(deltaX, deltaX), wasm_f32x4_mul(deltaY, deltaY)))};
+    sumX = wasm_f32x4_add(sumX, wasm_f32x4_mul(deltaX, length));
+    sumY = wasm_f32x4_add(sumY, wasm_f32x4_mul(deltaY, length));
+  }
+
+  glm::vec2 const sum{sumLanes(sumX), sumLanes(sumY)};
+  return sum + attractionRange(point, x, y, neighbors, j, count);
+}
+#endif
+
+LayoutKernels selectKernels() {
+#if defined(LAYOUT_KERNELS_AVX2)
+  if (supportsAvx2()) {
+    return {repulsionAvx2, attractionAvx2, "AVX2"};
+  }
+  return scalarLayoutKernels();
+#elif defined(LAYOUT_KERNELS_NEON)
+  return {repulsionNeon, attractionNeon, "NEON"};
+#elif defined(LAYOUT_KERNELS_SIMD128)
+  return {repulsionSimd128, attractionSimd128, "SIMD128"};
+#else
+  return scalarLayoutKernels();
+#endif
+}
+} // namespace
+
+LayoutKernels const &layoutKernels() {
+  static LayoutKernels const kernels{selectKernels()};
+  return kernels;
+}
+
+LayoutKernels const &scalarLayoutKernels() {
+  static LayoutKernels const kernels{repulsionScalar, attractionScalar,
+                                     "escalar"};
+  return kernels;
+}
@@ -0,0 +1,35 @@
+// layoutkernels.hpp
+
+#ifndef LAYOUTKERNELS_HPP_
+#define LAYOUTKERNELS_HPP_
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+
+// Laços internos do layout de forças sobre coordenadas em estrutura de
+// arrays (SoA), com versões SIMD escolhidas em tempo de execução: AVX2 + FMA
+// em x86-64 quando o processador suporta, NEON em ARM64 e SIMD128 em builds
+// WebAssembly compiladas com -msimd128, ou a versão escalar nos demais casos
+struct LayoutKernels {
+  // Soma de strength · m_j · (p - q_j) / |p - q_j|² sobre as fontes j de
+  // posição (x[j], y[j]) e massa mass[j]. Fontes que coincidem com p, como o
+  // próprio ponto, são ignoradas
+  glm::vec2 (*repulsion)(glm::vec2 point, float const *x, float const *y,
+                         float const *mass, std::size_t count,
+                         float strength);
+
+  // Soma de (q_j - p) · |q_j - p| sobre os vizinhos j, cujas posições são
+  // (x[neighbors[j]], y[neighbors[j]])
+  glm::vec2 (*attraction)(glm::vec2 point, float const *x, float const *y,
+                          int const *neighbors, std::size_t count);
+
+  char const *name;
+};
+
+// Melhor conjunto de kernels disponível neste processador
+LayoutKernels const &layoutKernels();
+
+// Versão escalar, para comparação
+LayoutKernels const &scalarLayoutKernels();
+
+#endif
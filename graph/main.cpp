@@ -3,6 +3,158 @@
 #include "abcg.hpp"
 #include "window.hpp"
 
+#include <bit>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+// Renderização em lote sem janela (EGL): gera `count` grafos com as sementes
+// 0, 1, ..., renderiza cada um em um framebuffer fora da tela e, se `prefix`
+// não for vazio, grava as imagens em <prefix>00000.png, <prefix>00001.png...
+// O tempo de renderização de cada quadro inclui glFinish, de modo que a média
+// impressa mede o caminho de desenho completo
+void renderHeadless(abcg::Application &app, Window &window, int count,
+                    std::string const &prefix) {
+  auto openGLSettings{window.getOpenGLSettings()};
+  openGLSettings.headless = true;
+  window.setOpenGLSettings(openGLSettings);
+  app.create(window);
+
+  double renderTime{};
+  for (auto const index : iter::range(count)) {
+    window.generateGraph(static_cast<std::uint64_t>(index));
+
+    abcg::Timer timer;
+    app.paintFrame();
+    glFinish();
+    renderTime += timer.elapsed();
+
+    if (!prefix.empty()) {
+      window.saveScreenshotPNG(fmt::format("{}{:05}.png", prefix, index));
+    }
+  }
+
+  fmt::print("{} quadros renderizados, {:.3f} ms por quadro\n", count,
+             count > 0 ? renderTime * 1000.0 / count : 0.0);
+  app.destroy();
+}
+
+// Grafo de Barabási–Albert com `numNodes` nós e 4 arestas por nó novo, e
+// posições aleatórias em [0, 1)², para os benchmarks do layout de forças
+void makeBenchmarkGraph(int numNodes, CSRGraph &graph, std::vector<float> &x,
+                        std::vector<float> &y) {
+  std::vector<Edge> edges;
+  barabasiAlbertParallel(numNodes, 4, 0, defaultThreadCount(), edges);
+  graph.build(numNodes, edges);
+
+  CounterRng const rng{0};
+  x.resize(static_cast<std::size_t>(numNodes));
+  y.resize(x.size());
+  for (auto const i : iter::range(x.size())) {
+    x[i] = static_cast<float>(CounterRng::toUnit(rng.at(2 * i)));
+    y[i] = static_cast<float>(CounterRng::toUnit(rng.at(2 * i + 1)));
+  }
+}
+
+// Escalabilidade do layout de forças, sem janela nem OpenGL: gera um grafo
+// de Barabási–Albert com `numNodes` nós e executa `iterations` iterações a
+// partir das mesmas posições com os kernels escalares e 1 thread e com os
+// kernels SIMD e 1, 2, 4, ..., 64 threads, imprimindo o tempo médio de cada
+// etapa. O hash das posições finais é o mesmo em todas as linhas SIMD, já
+// que o layout não depende do número de threads
+void benchmarkLayout(int numNodes, int iterations) {
+  CSRGraph graph;
+  std::vector<float> x;
+  std::vector<float> y;
+  makeBenchmarkGraph(numNodes, graph, x, y);
+
+  fmt::print("{} nós, {} arestas, {} iterações (ms por iteração)\n",
+             numNodes, graph.numEdges(), iterations);
+  fmt::print("{:>8} {:>7} {:>10} {:>10} {:>10} {:>10}  {}\n", "kernels",
+             "threads", "árvore", "forças", "integração", "total", "hash");
+  auto const measure{[&](bool useSimd, int threads) {
+    ForceLayout layout;
+    layout.settings().numThreads = threads;
+    layout.settings().useSimd = useSimd;
+    // Só o grafo original: os níveis grossos mudariam o que é medido
+    layout.settings().multilevel = false;
+    layout.settings().tolerance = 0.0f;
+    layout.settings().maxIterations = iterations;
+    layout.reset(x, y, graph);
+
+    ForceLayoutTimings sum;
+    while (!layout.converged()) {
+      layout.step();
+      sum.tree += layout.timings().tree;
+      sum.forces += layout.timings().forces;
+      sum.integration += layout.timings().integration;
+    }
+
+    std::uint64_t hash{0};
+    for (auto const i : iter::range(x.size())) {
+      hash = mix64(hash ^ std::bit_cast<std::uint32_t>(layout.x()[i]) ^
+                   (std::uint64_t{std::bit_cast<std::uint32_t>(layout.y()[i])}
+                    << 32U));
+    }
+    auto const count{static_cast<double>(std::max(layout.iteration(), 1))};
+    fmt::print("{:>8} {:>7} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}  "
+               "{:016x}\n",
+               useSimd ? layoutKernels().name : scalarLayoutKernels().name,
+               threads, sum.tree / count, sum.forces / count,
+               sum.integration / count, sum.total() / count, hash);
+  }};
+
+  measure(false, 1);
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    measure(true, threads);
+  }
+}
+
+// Tempo até a convergência do layout de forças no grafo de
+// makeBenchmarkGraph, diretamente no grafo original e pela hierarquia
+// multinível, partindo das posições aleatórias ou do Pivot-MDS (cujo tempo
+// é incluído). Sem a hierarquia, o Pivot-MDS só é refinado, como na janela
+void benchmarkMultilevel(int numNodes) {
+  CSRGraph graph;
+  std::vector<float> randomX;
+  std::vector<float> randomY;
+  makeBenchmarkGraph(numNodes, graph, randomX, randomY);
+
+  abcg::Timer pivotTimer;
+  CounterRng rng{0, 2};
+  std::vector<float> pivotX;
+  std::vector<float> pivotY;
+  pivotMds(graph, 32, defaultThreadCount(), rng, pivotX, pivotY);
+  auto const pivotTime{pivotTimer.elapsed()};
+
+  fmt::print("{} nós, {} arestas, Pivot-MDS em {:.2f} s\n", numNodes,
+             graph.numEdges(), pivotTime);
+  fmt::print("{:>10} {:>10} {:>7} {:>10} {:>10}\n", "início", "layout",
+             "níveis", "iterações", "tempo (s)");
+  for (auto const usePivotMds : {false, true}) {
+    for (auto const multilevel : {false, true}) {
+      ForceLayout layout;
+      layout.settings().multilevel = multilevel;
+      abcg::Timer timer;
+      if (usePivotMds) {
+        layout.reset(pivotX, pivotY, graph, !multilevel);
+      } else {
+        layout.reset(randomX, randomY, graph);
+      }
+      while (!layout.converged()) {
+        layout.step();
+      }
+      fmt::print("{:>10} {:>10} {:>7} {:>10} {:>10.2f}\n",
+                 usePivotMds ? "pivot-mds" : "aleatório",
+                 multilevel ? "multinível" : "direto", layout.levelCount(),
+                 layout.iteration(),
+                 timer.elapsed() + (usePivotMds ? pivotTime : 0.0));
+    }
+  }
+}
+} // namespace
+
 int main(int argc, char **argv) {
   try {
     abcg::Application app(argc, argv);
@@ -11,7 +163,28 @@ int main(int argc, char **argv) {
         .width = 800,
         .height = 600,
         .title = "Gerador de Grafos Aleatórios em 2D",
+        .onDemandRendering = true,
     });
+
+    // Uso: graph --headless <número de imagens> [prefixo dos arquivos]
+    //      graph --layout-benchmark <número de nós> [iterações]
+    //      graph --multilevel-benchmark <número de nós>
+    std::vector<std::string_view> const args(argv, argv + argc);
+    if (args.size() >= 3 && args[1] == "--layout-benchmark") {
+      benchmarkLayout(std::stoi(std::string{args[2]}),
+                      args.size() >= 4 ? std::stoi(std::string{args[3]}) : 10);
+      return 0;
+    }
+    if (args.size() >= 3 && args[1] == "--multilevel-benchmark") {
+      benchmarkMultilevel(std::stoi(std::string{args[2]}));
+      return 0;
+    }
+    if (args.size() >= 3 && args[1] == "--headless") {
+      renderHeadless(app, window, std::stoi(std::string{args[2]}),
+                     args.size() >= 4 ? std::string{args[3]} : std::string{});
+      return 0;
+    }
+
     app.run(window);
   } catch (std::exception const &e) {
     fmt::print("Exception: {}\n", e.what());
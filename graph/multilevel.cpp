@@ -0,0 +1,200 @@
+// multilevel.cpp
+
+#include "multilevel.hpp"
+
+#include <limits>
+#include <utility>
+
+#include "rng.hpp"
+
+namespace {
+constexpr auto unassigned{std::numeric_limits<std::uint32_t>::max()};
+} // namespace
+
+void GraphHierarchy::build(CSRGraph const &graph, bool multilevel,
+                           std::atomic<bool> const *cancel) {
+  m_graph = &graph;
+  m_coarse.clear();
+  m_parents.clear();
+  if (!multilevel) {
+    return;
+  }
+
+  std::vector<float> weights(static_cast<std::size_t>(graph.numNodes()),
+                             1.0f);
+  auto const cancelled{[&] {
+    return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+  }};
+  while (levelCount() < m_maxLevels && !cancelled()) {
+    auto const &fine{this->graph(levelCount() - 1)};
+    auto const numFine{static_cast<std::size_t>(fine.numNodes())};
+    if (numFine <= m_minNodes) {
+      break;
+    }
+
+    std::vector<std::uint32_t> parents;
+    std::vector<float> coarseWeights;
+    auto const numCoarse{coarsen(fine, weights, parents, coarseWeights)};
+    if (static_cast<double>(numCoarse) >
+        m_minReduction * static_cast<double>(numFine)) {
+      break;
+    }
+
+    CSRGraph coarse;
+    if (!buildCoarseGraph(fine, parents, numCoarse, coarse, cancel)) {
+      break;
+    }
+    m_parents.push_back(std::move(parents));
+    m_coarse.push_back(std::move(coarse));
+    weights = std::move(coarseWeights);
+  }
+}
+
+CSRGraph const &GraphHierarchy::graph(int level) const {
+  return level == 0 ? *m_graph
+                    : m_coarse[static_cast<std::size_t>(level - 1)];
+}
+
+std::size_t GraphHierarchy::coarsen(CSRGraph const &graph,
+                                    std::span<float const> weights,
+                                    std::vector<std::uint32_t> &parents,
+                                    std::vector<float> &coarseWeights) {
+  auto const numNodes{static_cast<std::size_t>(graph.numNodes())};
+  parents.assign(numNodes, unassigned);
+  coarseWeights.clear();
+
+  // Emparelhamento maximal: cada nó livre se junta ao vizinho livre de menor
+  // peso, o que mantém os grupos equilibrados
+  for (std::size_t node = 0; node < numNodes; ++node) {
+    if (parents[node] != unassigned) {
+      continue;
+    }
+    auto best{unassigned};
+    for (auto const neighbor : graph.neighbors(static_cast<int>(node))) {
+      auto const index{static_cast<std::uint32_t>(neighbor)};
+      if (index != node && parents[index] == unassigned &&
+          (best == unassigned || weights[index] < weights[best])) {
+        best = index;
+      }
+    }
+    if (best != unassigned) {
+      parents[node] = parents[best] =
+          static_cast<std::uint32_t>(coarseWeights.size());
+      coarseWeights.push_back(weights[node] + weights[best]);
+    }
+  }
+
+  // Os nós sem par têm todos os vizinhos emparelhados (o emparelhamento é
+  // maximal) e entram no grupo vizinho de menor peso; nós isolados formam um
+  // grupo sozinhos
+  for (std::size_t node = 0; node < numNodes; ++node) {
+    if (parents[node] != unassigned) {
+      continue;
+    }
+    auto best{unassigned};
+    for (auto const neighbor : graph.neighbors(static_cast<int>(node))) {
+      auto const group{parents[static_cast<std::size_t>(neighbor)]};
+      if (group != unassigned &&
+          (best == unassigned || coarseWeights[group] < coarseWeights[best])) {
+        best = group;
+      }
+    }
+    if (best == unassigned) {
+      best = static_cast<std::uint32_t>(coarseWeights.size());
+      coarseWeights.push_back(0.0f);
+    }
+    parents[node] = best;
+    coarseWeights[best] += weights[node];
+  }
+  return coarseWeights.size();
+}
+
+bool GraphHierarchy::buildCoarseGraph(CSRGraph const &graph,
+                                      std::span<std::uint32_t const> parents,
+                                      std::size_t numCoarse, CSRGraph &coarse,
+                                      std::atomic<bool> const *cancel) {
+  // Nós de cada grupo, contíguos (counting sort pelo grupo)
+  std::vector<std::size_t> offsets(numCoarse + 1, 0);
+  for (auto const parent : parents) {
+    ++offsets[parent + 1];
+  }
+  for (std::size_t group = 1; group <= numCoarse; ++group) {
+    offsets[group] += offsets[group - 1];
+  }
+  std::vector<std::uint32_t> members(parents.size());
+  std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (std::size_t node = 0; node < parents.size(); ++node) {
+    members[cursor[parents[node]]++] = static_cast<std::uint32_t>(node);
+  }
+
+  // Uma aresta entre dois grupos para cada par de grupos com nós vizinhos,
+  // sem laços; `seen` marca os grupos já ligados ao grupo atual
+  std::vector<Edge> edges;
+  std::vector<std::uint32_t> seen(numCoarse, unassigned);
+  for (std::size_t group = 0; group < numCoarse; ++group) {
+    if (group % m_cancelInterval == 0 && cancel != nullptr &&
+        cancel->load(std::memory_order_relaxed)) {
+      return false;
+    }
+    auto const groupIndex{static_cast<std::uint32_t>(group)};
+    for (auto member{offsets[group]}; member < offsets[group + 1]; ++member) {
+      for (auto const neighbor :
+           graph.neighbors(static_cast<int>(members[member]))) {
+        auto const other{parents[static_cast<std::size_t>(neighbor)]};
+        if (other == groupIndex || seen[other] == groupIndex) {
+          continue;
+        }
+        seen[other] = groupIndex;
+        if (groupIndex < other) {
+          edges.push_back({static_cast<int>(groupIndex),
+                           static_cast<int>(other)});
+        }
+      }
+    }
+  }
+  coarse.build(static_cast<int>(numCoarse), edges);
+  return true;
+}
+
+void GraphHierarchy::restrict(int level, std::span<float const> x,
+                              std::span<float const> y,
+                              std::vector<float> &coarseX,
+                              std::vector<float> &coarseY) const {
+  auto const &parents{m_parents[static_cast<std::size_t>(level)]};
+  auto const numCoarse{
+      static_cast<std::size_t>(graph(level + 1).numNodes())};
+  coarseX.assign(numCoarse, 0.0f);
+  coarseY.assign(numCoarse, 0.0f);
+  std::vector<float> counts(numCoarse, 0.0f);
+  for (std::size_t node = 0; node < parents.size(); ++node) {
+    coarseX[parents[node]] += x[node];
+    coarseY[parents[node]] += y[node];
+    counts[parents[node]] += 1.0f;
+  }
+  for (std::size_t group = 0; group < numCoarse; ++group) {
+    coarseX[group] /= counts[group];
+    coarseY[group] /= counts[group];
+  }
+}
+
+void GraphHierarchy::prolong(int level, std::span<float const> coarseX,
+                             std::span<float const> coarseY, float scale,
+                             float jitter, std::vector<float> &x,
+                             std::vector<float> &y) const {
+  auto const &parents{m_parents[static_cast<std::size_t>(level)]};
+  CounterRng const rng{static_cast<std::uint64_t>(level)};
+  x.resize(parents.size());
+  y.resize(parents.size());
+  for (std::size_t node = 0; node < parents.size(); ++node) {
+    x[node] = coarseX[parents[node]] * scale;
+    y[node] = coarseY[parents[node]] * scale;
+  }
+  if (jitter > 0.0f) {
+    for (std::size_t node = 0; node < parents.size(); ++node) {
+      auto const offsetX{CounterRng::toUnit(rng.at(2 * node)) - 0.5};
+      auto const offsetY{CounterRng::toUnit(rng.at(2 * node + 1)) - 0.5};
+      x[node] += 2.0f * jitter * static_cast<float>(offsetX);
+      y[node] += 2.0f * jitter * static_cast<float>(offsetY);
+    }
+  }
+}
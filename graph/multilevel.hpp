@@ -0,0 +1,70 @@
+// multilevel.hpp
+
+#ifndef MULTILEVEL_HPP_
+#define MULTILEVEL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "csrgraph.hpp"
+
+// Hierarquia de grafos cada vez menores para o layout multinível (Hu,
+// FM³). O nível 0 é o grafo original; cada nível seguinte junta pares de nós
+// vizinhos por um emparelhamento que prefere o vizinho de menor peso
+// (número de nós originais representados), e os nós que ficaram sem par
+// entram no grupo vizinho de menor peso. Assim estrelas e árvores, em que
+// um emparelhamento sozinho reduz pouco o grafo, também encolhem pelo menos
+// pela metade a cada nível. A hierarquia para quando o grafo tem no máximo
+// m_minNodes nós ou quando um nível reduz menos que m_minReduction
+class GraphHierarchy {
+public:
+  // `graph` precisa continuar válido enquanto a hierarquia for usada. Com
+  // `multilevel` falso, a hierarquia tem apenas o nível 0. Quando `cancel`
+  // passa a ser verdadeiro (em outra thread), a construção é interrompida e
+  // a hierarquia fica incompleta
+  void build(CSRGraph const &graph, bool multilevel = true,
+             std::atomic<bool> const *cancel = nullptr);
+
+  [[nodiscard]] int levelCount() const {
+    return static_cast<int>(m_coarse.size()) + 1;
+  }
+  [[nodiscard]] CSRGraph const &graph(int level) const;
+
+  // Posições no nível level + 1: média dos nós agrupados
+  void restrict(int level, std::span<float const> x, std::span<float const> y,
+                std::vector<float> &coarseX,
+                std::vector<float> &coarseY) const;
+
+  // Posições no nível `level` a partir das do nível level + 1: cada nó
+  // recebe a posição do seu grupo multiplicada por `scale`, mais um desvio
+  // pseudoaleatório de até `jitter` em cada eixo (que separa os nós do grupo)
+  void prolong(int level, std::span<float const> coarseX,
+               std::span<float const> coarseY, float scale, float jitter,
+               std::vector<float> &x, std::vector<float> &y) const;
+
+private:
+  static std::size_t coarsen(CSRGraph const &graph,
+                             std::span<float const> weights,
+                             std::vector<std::uint32_t> &parents,
+                             std::vector<float> &coarseWeights);
+  static bool buildCoarseGraph(CSRGraph const &graph,
+                               std::span<std::uint32_t const> parents,
+                               std::size_t numCoarse, CSRGraph &coarse,
+                               std::atomic<bool> const *cancel);
+
+  static constexpr std::size_t m_minNodes{64};
+  // Grupos entre duas verificações de `cancel`
+  static constexpr std::size_t m_cancelInterval{16384};
+  static constexpr double m_minReduction{0.8};
+  static constexpr int m_maxLevels{40};
+
+  CSRGraph const *m_graph{};
+  std::vector<CSRGraph> m_coarse; // Níveis 1, 2, ...
+  // Nó do nível seguinte que contém cada nó dos níveis 0, 1, ...
+  std::vector<std::vector<std::uint32_t>> m_parents;
+};
+
+#endif
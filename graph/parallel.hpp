@@ -0,0 +1,61 @@
+// parallel.hpp
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Número de threads padrão: os núcleos disponíveis, ou 1 em builds
+// WebAssembly sem suporte a threads
+inline int defaultThreadCount() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  return 1;
+#else
+  return static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+#endif
+}
+
+// Divide [0, count) em `numChunks` blocos contíguos e executa
+// fn(chunk, begin, end) para cada um, distribuindo os blocos entre até
+// `numThreads` threads. Os limites dos blocos dependem apenas de `count` e
+// `numChunks`, o que permite resultados determinísticos independentemente do
+// número de threads
+template <typename Fn>
+void parallelChunks(std::size_t count, std::size_t numChunks, int numThreads,
+                    Fn &&fn) {
+  numChunks = std::max<std::size_t>(numChunks, 1);
+  auto const chunkBegin{[&](std::size_t chunk) {
+    return count * chunk / numChunks;
+  }};
+
+  auto const worker{[&](std::size_t firstChunk, std::size_t stride) {
+    for (auto chunk{firstChunk}; chunk < numChunks; chunk += stride) {
+      fn(chunk, chunkBegin(chunk), chunkBegin(chunk + 1));
+    }
+  }};
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  numThreads = 1;
+#endif
+  auto const threads{std::min(static_cast<std::size_t>(std::max(numThreads, 1)),
+                              numChunks)};
+  if (threads == 1) {
+    worker(0, 1);
+    return;
+  }
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (std::size_t t = 1; t < threads; ++t) {
+    pool.emplace_back(worker, t, threads);
+  }
+  worker(0, threads);
+  for (auto &thread : pool) {
+    thread.join();
+  }
+}
+
+#endif
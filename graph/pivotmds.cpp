@@ -0,0 +1,271 @@
+// pivotmds.cpp
+
+#include "pivotmds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+
+#include "parallel.hpp"
+
+namespace {
+// Nós por bloco nas etapas paralelas sobre os nós
+constexpr std::size_t chunkSize{16384};
+
+// Distâncias em saltos de `source` a todos os nós, por busca em largura.
+// Os nós inalcançáveis ficam à maior distância encontrada mais 1. Os nós
+// visitados são marcados em um bitset (n / 8 bytes, que cabe na cache), e
+// não testados na coluna de distâncias
+void bfsDistances(CSRGraph const &graph, int source,
+                  std::span<float> distances, std::vector<int> &queue,
+                  std::vector<std::uint64_t> &visited) {
+  auto const mark{[&](int node) {
+    auto const index{static_cast<std::size_t>(node)};
+    auto const bit{std::uint64_t{1} << (index % 64)};
+    auto &word{visited[index / 64]};
+    auto const isNew{(word & bit) == 0};
+    word |= bit;
+    return isNew;
+  }};
+
+  std::fill(visited.begin(), visited.end(), 0);
+  queue.clear();
+  mark(source);
+  queue.push_back(source);
+
+  // Nível a nível: os nós de queue[levelBegin, levelEnd) estão à
+  // distância `level`
+  float level{0.0f};
+  std::size_t levelBegin{0};
+  while (levelBegin < queue.size()) {
+    auto const levelEnd{queue.size()};
+    for (auto head{levelBegin}; head < levelEnd; ++head) {
+      auto const node{queue[head]};
+      distances[static_cast<std::size_t>(node)] = level;
+      for (auto const neighbor : graph.neighbors(node)) {
+        if (mark(neighbor)) {
+          queue.push_back(neighbor);
+        }
+      }
+    }
+    levelBegin = levelEnd;
+    level += 1.0f;
+  }
+
+  if (queue.size() < distances.size()) {
+    for (std::size_t node = 0; node < distances.size(); ++node) {
+      if ((visited[node / 64] & (std::uint64_t{1} << (node % 64))) == 0) {
+        distances[node] = level;
+      }
+    }
+  }
+}
+
+// `count` nós distintos sorteados em [0, numNodes), ou todos se não houver
+// nós suficientes
+std::vector<int> samplePivots(int numNodes, int count, CounterRng &rng) {
+  std::vector<int> pivots;
+  if (count >= numNodes) {
+    pivots.resize(static_cast<std::size_t>(numNodes));
+    std::iota(pivots.begin(), pivots.end(), 0);
+    return pivots;
+  }
+  while (pivots.size() < static_cast<std::size_t>(count)) {
+    auto const node{static_cast<int>(
+        rng.below(static_cast<std::uint64_t>(numNodes)))};
+    if (std::find(pivots.begin(), pivots.end(), node) == pivots.end()) {
+      pivots.push_back(node);
+    }
+  }
+  return pivots;
+}
+
+// Autovetores unitários dos dois maiores autovalores da matriz simétrica
+// semidefinida positiva k × k `matrix`, por iteração de potências: o
+// segundo é mantido ortogonal ao primeiro (deflação)
+std::array<std::vector<double>, 2>
+topEigenvectors(std::span<double const> matrix, std::size_t k) {
+  constexpr int maxIterations{1000};
+  constexpr double tolerance{1e-10};
+
+  std::array<std::vector<double>, 2> vectors;
+  std::vector<double> product(k);
+  for (std::size_t index = 0; index < vectors.size(); ++index) {
+    auto &vector{vectors[index]};
+    CounterRng const start{index};
+    vector.resize(k);
+    for (std::size_t i = 0; i < k; ++i) {
+      vector[i] = CounterRng::toUnit(start.at(i)) - 0.5;
+    }
+
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+      for (std::size_t row = 0; row < k; ++row) {
+        product[row] = std::inner_product(
+            vector.begin(), vector.end(), matrix.begin() + row * k, 0.0);
+      }
+      for (std::size_t previous = 0; previous < index; ++previous) {
+        auto const &other{vectors[previous]};
+        auto const projection{std::inner_product(
+            product.begin(), product.end(), other.begin(), 0.0)};
+        for (std::size_t i = 0; i < k; ++i) {
+          product[i] -= projection * other[i];
+        }
+      }
+      auto const norm{std::sqrt(std::inner_product(
+          product.begin(), product.end(), product.begin(), 0.0))};
+      if (norm == 0.0) {
+        break;
+      }
+
+      double change{0.0};
+      for (std::size_t i = 0; i < k; ++i) {
+        auto const value{product[i] / norm};
+        change = std::max(change, std::abs(value - vector[i]));
+        vector[i] = value;
+      }
+      if (change < tolerance) {
+        break;
+      }
+    }
+  }
+  return vectors;
+}
+} // namespace
+
+int maxPivots(int numNodes) {
+  auto const n{static_cast<std::size_t>(std::max(numNodes, 1))};
+  return static_cast<int>(std::clamp<std::size_t>(maxPivotMdsEntries / (2 * n),
+                                                  2, 1 << 20));
+}
+
+void pivotMds(CSRGraph const &graph, int numPivots, int numThreads,
+              CounterRng &rng, std::vector<float> &x, std::vector<float> &y) {
+  auto const n{static_cast<std::size_t>(graph.numNodes())};
+  x.assign(n, 0.0f);
+  y.assign(n, 0.0f);
+  if (n < 2) {
+    return;
+  }
+
+  // Uma coluna de n distâncias por pivô, preenchidas em paralelo
+  numPivots = std::clamp(numPivots, 2, maxPivots(graph.numNodes()));
+  auto const pivots{samplePivots(graph.numNodes(), numPivots, rng)};
+  auto const k{pivots.size()};
+  std::vector<float> columns(n * k);
+  auto const column{[&](std::size_t pivot) {
+    return std::span<float>{columns.data() + pivot * n, n};
+  }};
+  parallelChunks(k, k, numThreads,
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+                   std::vector<int> queue;
+                   queue.reserve(n);
+                   std::vector<std::uint64_t> visited((n + 63) / 64);
+                   for (auto pivot{begin}; pivot < end; ++pivot) {
+                     bfsDistances(graph, pivots[pivot], column(pivot), queue,
+                                  visited);
+                   }
+                 });
+
+  // Centralização dupla dos quadrados das distâncias, no lugar:
+  // c_ij = -(d_ij² - média da linha i - média da coluna j + média geral) / 2
+  std::vector<double> columnMeans(k);
+  parallelChunks(k, k, numThreads,
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+                   for (auto pivot{begin}; pivot < end; ++pivot) {
+                     double sum{0.0};
+                     for (auto &distance : column(pivot)) {
+                       distance *= distance;
+                       sum += distance;
+                     }
+                     columnMeans[pivot] = sum / static_cast<double>(n);
+                   }
+                 });
+  auto const grandMean{
+      std::accumulate(columnMeans.begin(), columnMeans.end(), 0.0) /
+      static_cast<double>(k)};
+
+  auto const numChunks{(n + chunkSize - 1) / chunkSize};
+  parallelChunks(
+      n, numChunks, numThreads,
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto node{begin}; node < end; ++node) {
+          double rowSum{0.0};
+          for (std::size_t pivot = 0; pivot < k; ++pivot) {
+            rowSum += columns[pivot * n + node];
+          }
+          auto const rowMean{rowSum / static_cast<double>(k)};
+          for (std::size_t pivot = 0; pivot < k; ++pivot) {
+            auto &value{columns[pivot * n + node]};
+            value = static_cast<float>(
+                -0.5 * (value - rowMean - columnMeans[pivot] + grandMean));
+          }
+        }
+      });
+
+  // CᵀC, somada por blocos de nós e depois na ordem dos blocos
+  std::vector<std::vector<double>> partials(numChunks);
+  parallelChunks(
+      n, numChunks, numThreads,
+      [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        auto &partial{partials[chunk]};
+        partial.assign(k * k, 0.0);
+        for (std::size_t a = 0; a < k; ++a) {
+          auto const *columnA{columns.data() + a * n};
+          for (std::size_t b = 0; b <= a; ++b) {
+            auto const *columnB{columns.data() + b * n};
+            double sum{0.0};
+            for (auto node{begin}; node < end; ++node) {
+              sum += static_cast<double>(columnA[node]) * columnB[node];
+            }
+            partial[a * k + b] = sum;
+          }
+        }
+      });
+  std::vector<double> product(k * k, 0.0);
+  for (auto const &partial : partials) {
+    for (std::size_t a = 0; a < k; ++a) {
+      for (std::size_t b = 0; b <= a; ++b) {
+        product[a * k + b] += partial[a * k + b];
+      }
+    }
+  }
+  for (std::size_t a = 0; a < k; ++a) {
+    for (std::size_t b = 0; b < a; ++b) {
+      product[b * k + a] = product[a * k + b];
+    }
+  }
+
+  // Projeção nos dois autovetores, e o desvio de até um décimo do
+  // espaçamento médio entre nós
+  auto const [first, second]{topEigenvectors(product, k)};
+  parallelChunks(n, numChunks, numThreads,
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+                   for (auto node{begin}; node < end; ++node) {
+                     double sumX{0.0};
+                     double sumY{0.0};
+                     for (std::size_t pivot = 0; pivot < k; ++pivot) {
+                       auto const value{columns[pivot * n + node]};
+                       sumX += value * first[pivot];
+                       sumY += value * second[pivot];
+                     }
+                     x[node] = static_cast<float>(sumX);
+                     y[node] = static_cast<float>(sumY);
+                   }
+                 });
+
+  auto const [lowX, highX]{std::minmax_element(x.begin(), x.end())};
+  auto const [lowY, highY]{std::minmax_element(y.begin(), y.end())};
+  auto extent{std::max(*highX - *lowX, *highY - *lowY)};
+  if (extent == 0.0f) {
+    extent = 1.0f;
+  }
+  auto const jitter{0.1f * extent / std::sqrt(static_cast<float>(n))};
+  for (std::size_t node = 0; node < n; ++node) {
+    x[node] += jitter * (static_cast<float>(rng.uniform()) - 0.5f);
+    y[node] += jitter * (static_cast<float>(rng.uniform()) - 0.5f);
+  }
+}
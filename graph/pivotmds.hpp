@@ -0,0 +1,37 @@
+// pivotmds.hpp
+
+#ifndef PIVOTMDS_HPP_
+#define PIVOTMDS_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "csrgraph.hpp"
+#include "rng.hpp"
+
+// Posições iniciais por Pivot-MDS (Brandes e Pich, 2006): uma busca em
+// largura a partir de cada um de `numPivots` pivôs sorteados dá a matriz C
+// de n × k distâncias em saltos, cujos quadrados são centralizados como no
+// MDS clássico. Os dois maiores autovetores da matriz k × k CᵀC, obtidos
+// por iteração de potências, projetam cada nó em duas dimensões: x = C·v₁ e
+// y = C·v₂. O custo é O(k·(n + m)) para as buscas, distribuídas entre
+// `numThreads` threads (uma busca por pivô), mais O(k²·n) para CᵀC, e o
+// resultado preserva a estrutura global do grafo, um bom ponto de partida
+// para o layout de forças. Nós inalcançáveis a partir de um pivô ficam a
+// uma distância maior que a do nó mais distante da sua componente. Todos os
+// nós recebem um desvio pseudoaleatório de até um décimo do espaçamento
+// médio (0,1 · extensão / √n), pequeno demais para mudar o desenho mas
+// suficiente para separar os nós à mesma distância de todos os pivôs, que
+// de outro modo coincidiriam. O número de pivôs é limitado por maxPivots
+void pivotMds(CSRGraph const &graph, int numPivots, int numThreads,
+              CounterRng &rng, std::vector<float> &x, std::vector<float> &y);
+
+// A matriz de distâncias e as filas das buscas ocupam até 2·n·k valores de 4
+// bytes, limitados a maxPivotMdsEntries (512 MB)
+inline constexpr std::size_t maxPivotMdsEntries{std::size_t{1} << 27};
+
+// Maior número de pivôs com `numNodes` nós dentro do limite de memória (pelo
+// menos 2)
+int maxPivots(int numNodes);
+
+#endif
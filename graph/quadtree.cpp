@@ -0,0 +1,317 @@
+// quadtree.cpp
+
+#include "quadtree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <limits>
+#include <utility>
+
+namespace {
+// Espalha os 20 bits baixos de x nas posições pares de um inteiro de 64 bits
+std::uint64_t spreadBits(std::uint64_t x) {
+  x &= 0xFFFFFULL;
+  x = (x | (x << 16U)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8U)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2U)) & 0x3333333333333333ULL;
+  x = (x | (x << 1U)) & 0x5555555555555555ULL;
+  return x;
+}
+
+// Blocos das etapas paralelas da ordenação: dependem só do número de pontos
+std::size_t sortChunks(std::size_t count) {
+  return std::clamp<std::size_t>(count / 4096, 1, 64);
+}
+} // namespace
+
+void QuadTree::build(std::span<float const> x, std::span<float const> y,
+                     ThreadPool &pool) {
+  m_cells.clear();
+  m_cells.push_back(
+      {.size = 0.0f, .begin = 0, .end = static_cast<std::uint32_t>(x.size())});
+  sortPoints(x, y, pool);
+  if (x.empty()) {
+    return;
+  }
+  m_cells.front().size = m_rootSize;
+
+  // Níveis de cima, em largura: as filhas ficam sempre depois da mãe
+  std::vector<int> depths{0};
+  std::vector<std::size_t> tasks;
+  for (std::size_t cell = 0; cell < m_cells.size(); ++cell) {
+    auto const count{m_cells[cell].end - m_cells[cell].begin};
+    auto const depth{depths[cell]};
+    if (count > m_taskSize && depth < m_maxDepth) {
+      splitCell(m_cells, cell, depth);
+      depths.resize(m_cells.size(), depth + 1);
+    } else {
+      tasks.push_back(cell);
+    }
+  }
+  auto const topCount{m_cells.size()};
+
+  // Cada subárvore é construída em um vetor próprio, com a raiz no índice 0
+  m_subtrees.resize(tasks.size());
+  pool.forEachChunk(
+      tasks.size(), tasks.size(),
+      [&](std::size_t task, std::size_t, std::size_t) {
+        auto &subtree{m_subtrees[task]};
+        subtree.assign(1, m_cells[tasks[task]]);
+        buildSubtree(subtree, 0, depths[tasks[task]]);
+      });
+
+  // Concatena as subárvores na ordem das tarefas: a raiz substitui a célula
+  // da fronteira e as demais vão para o fim, com os índices deslocados
+  std::vector<std::size_t> offsets(tasks.size() + 1, topCount);
+  for (std::size_t task = 0; task < tasks.size(); ++task) {
+    offsets[task + 1] = offsets[task] + m_subtrees[task].size() - 1;
+  }
+  m_cells.resize(offsets.back());
+  pool.forEachChunk(
+      tasks.size(), tasks.size(),
+      [&](std::size_t task, std::size_t, std::size_t) {
+        auto const &subtree{m_subtrees[task]};
+        auto const shift{static_cast<std::uint32_t>(offsets[task] - 1)};
+        for (std::size_t local = 0; local < subtree.size(); ++local) {
+          auto cell{subtree[local]};
+          if (cell.firstChild != 0) {
+            cell.firstChild += shift;
+          }
+          m_cells[local == 0 ? tasks[task] : shift + local] = cell;
+        }
+      });
+
+  // Massas dos níveis de cima, de baixo para cima
+  for (auto cell{topCount}; cell-- > 0;) {
+    if (m_cells[cell].firstChild != 0) {
+      mergeChildren(m_cells, m_cells[cell]);
+    }
+  }
+}
+
+void QuadTree::sortPoints(std::span<float const> x, std::span<float const> y,
+                          ThreadPool &pool) {
+  auto const count{x.size()};
+  auto const numChunks{sortChunks(count)};
+  m_keys.resize(count);
+  m_buffer.resize(count);
+  m_codes.resize(count);
+  m_order.resize(count);
+  m_sortedX.resize(count);
+  m_sortedY.resize(count);
+  if (count == 0) {
+    return;
+  }
+
+  // Caixa quadrada que envolve todos os pontos
+  std::vector<std::pair<glm::vec2, glm::vec2>> bounds(
+      numChunks, {glm::vec2{std::numeric_limits<float>::max()},
+                  glm::vec2{std::numeric_limits<float>::lowest()}});
+  pool.forEachChunk(count, numChunks,
+                    [&](std::size_t chunk, std::size_t begin,
+                        std::size_t end) {
+                      auto &[low, high]{bounds[chunk]};
+                      for (auto i{begin}; i < end; ++i) {
+                        glm::vec2 const point{x[i], y[i]};
+                        low = glm::min(low, point);
+                        high = glm::max(high, point);
+                      }
+                    });
+  auto low{bounds.front().first};
+  auto high{bounds.front().second};
+  for (auto const &[chunkLow, chunkHigh] : bounds) {
+    low = glm::min(low, chunkLow);
+    high = glm::max(high, chunkHigh);
+  }
+  m_rootSize = std::max(high.x - low.x, high.y - low.y) * (1.0f + 1e-6f) +
+               1e-6f;
+
+  // Chave: código de Morton das coordenadas quantizadas em m_maxDepth bits,
+  // seguido do índice do ponto
+  constexpr auto cellsPerSide{1U << static_cast<unsigned>(m_maxDepth)};
+  auto const scale{static_cast<float>(cellsPerSide) / m_rootSize};
+  pool.forEachChunk(
+      count, numChunks,
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto i{begin}; i < end; ++i) {
+          glm::vec2 const point{x[i], y[i]};
+          auto const cell{glm::min(glm::uvec2{(point - low) * scale},
+                                   glm::uvec2{cellsPerSide - 1})};
+          auto const code{spreadBits(cell.x) | (spreadBits(cell.y) << 1U)};
+          m_keys[i] = (code << static_cast<unsigned>(m_indexBits)) | i;
+        }
+      });
+
+  // Radix sort LSD apenas dos bits do código, 11 bits por passada: a
+  // ordenação estável mantém os empates na ordem dos índices. Em cada
+  // passada cada bloco conta os seus dígitos, as contagens são acumuladas na
+  // ordem (dígito, bloco) e cada bloco espalha as suas chaves
+  constexpr int digitBits{11};
+  constexpr std::size_t radix{std::size_t{1} << digitBits};
+  std::vector<std::array<std::size_t, radix>> offsets(numChunks);
+  for (auto shift{m_indexBits}; shift < m_indexBits + 2 * m_maxDepth;
+       shift += digitBits) {
+    auto const digit{[shift](std::uint64_t key) {
+      return static_cast<std::size_t>((key >> static_cast<unsigned>(shift)) &
+                                      (radix - 1));
+    }};
+
+    pool.forEachChunk(count, numChunks,
+                      [&](std::size_t chunk, std::size_t begin,
+                          std::size_t end) {
+                        auto &counts{offsets[chunk]};
+                        counts.fill(0);
+                        for (auto i{begin}; i < end; ++i) {
+                          ++counts[digit(m_keys[i])];
+                        }
+                      });
+
+    std::size_t position{0};
+    for (std::size_t d = 0; d < radix; ++d) {
+      for (auto &counts : offsets) {
+        position += std::exchange(counts[d], position);
+      }
+    }
+
+    pool.forEachChunk(count, numChunks,
+                      [&](std::size_t chunk, std::size_t begin,
+                          std::size_t end) {
+                        auto &next{offsets[chunk]};
+                        for (auto i{begin}; i < end; ++i) {
+                          m_buffer[next[digit(m_keys[i])]++] = m_keys[i];
+                        }
+                      });
+    m_keys.swap(m_buffer);
+  }
+
+  constexpr auto indexMask{(std::uint64_t{1} << m_indexBits) - 1};
+  pool.forEachChunk(
+      count, numChunks,
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto i{begin}; i < end; ++i) {
+          m_codes[i] = m_keys[i] >> static_cast<unsigned>(m_indexBits);
+          m_order[i] = static_cast<std::uint32_t>(m_keys[i] & indexMask);
+          m_sortedX[i] = x[m_order[i]];
+          m_sortedY[i] = y[m_order[i]];
+        }
+      });
+}
+
+void QuadTree::splitCell(std::vector<Cell> &cells, std::size_t cell,
+                         int depth) const {
+  // Dentro da célula o dígito de 2 bits deste nível é não decrescente; os
+  // quadrantes ficam na ordem (esquerda-baixo, direita-baixo, esquerda-cima,
+  // direita-cima)
+  auto const shift{static_cast<unsigned>(2 * (m_maxDepth - 1 - depth))};
+  auto const first{m_codes.begin() + cells[cell].begin};
+  auto const last{m_codes.begin() + cells[cell].end};
+  std::array<std::uint32_t, 5> bounds{cells[cell].begin, 0, 0, 0,
+                                      cells[cell].end};
+  for (std::uint64_t quadrant = 1; quadrant < 4; ++quadrant) {
+    auto const split{std::partition_point(first, last, [&](std::uint64_t c) {
+      return ((c >> shift) & 3U) < quadrant;
+    })};
+    bounds[quadrant] = static_cast<std::uint32_t>(split - m_codes.begin());
+  }
+
+  auto const firstChild{static_cast<std::uint32_t>(cells.size())};
+  auto const size{cells[cell].size * 0.5f};
+  cells[cell].firstChild = firstChild;
+  for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+    cells.push_back(
+        {.size = size, .begin = bounds[quadrant], .end = bounds[quadrant + 1]});
+  }
+}
+
+void QuadTree::buildSubtree(std::vector<Cell> &cells, std::size_t cell,
+                            int depth) const {
+  if (cells[cell].end - cells[cell].begin <= m_leafSize ||
+      depth == m_maxDepth) {
+    setLeaf(cells[cell]);
+    return;
+  }
+
+  splitCell(cells, cell, depth);
+  auto const firstChild{cells[cell].firstChild};
+  for (std::uint32_t child = 0; child < 4; ++child) {
+    buildSubtree(cells, firstChild + child, depth + 1);
+  }
+  mergeChildren(cells, cells[cell]);
+}
+
+void QuadTree::setLeaf(Cell &cell) const {
+  glm::vec2 sum{};
+  for (auto i{cell.begin}; i < cell.end; ++i) {
+    sum += glm::vec2{m_sortedX[i], m_sortedY[i]};
+  }
+  cell.firstChild = 0;
+  cell.mass = static_cast<float>(cell.end - cell.begin);
+  cell.centerOfMass = cell.mass > 0.0f ? sum / cell.mass : glm::vec2{};
+}
+
+void QuadTree::mergeChildren(std::span<Cell> cells, Cell &parent) {
+  glm::vec2 weightedSum{};
+  float mass{};
+  for (std::uint32_t child = 0; child < 4; ++child) {
+    auto const &cell{cells[parent.firstChild + child]};
+    weightedSum += cell.centerOfMass * cell.mass;
+    mass += cell.mass;
+  }
+  parent.mass = mass;
+  parent.centerOfMass = mass > 0.0f ? weightedSum / mass : glm::vec2{};
+}
+
+void QuadTree::collectSources(std::size_t begin, std::size_t end,
+                              float theta, RepulsionSources &sources) const {
+  sources.clear();
+  glm::vec2 low{std::numeric_limits<float>::max()};
+  glm::vec2 high{std::numeric_limits<float>::lowest()};
+  for (auto i{begin}; i < end; ++i) {
+    glm::vec2 const point{m_sortedX[i], m_sortedY[i]};
+    low = glm::min(low, point);
+    high = glm::max(high, point);
+  }
+  auto const theta2{theta * theta};
+
+  // Percurso em profundidade com pilha explícita: cada célula aberta empilha
+  // quatro filhas, então 4 * (m_maxDepth + 1) entradas bastam
+  std::array<std::uint32_t, 4 * (m_maxDepth + 1)> stack{};
+  std::size_t top{0};
+  stack[top++] = 0;
+
+  while (top > 0) {
+    auto const &cell{m_cells[stack[--top]]};
+    if (cell.mass == 0.0f) {
+      continue;
+    }
+
+    if (cell.firstChild == 0) {
+      // Pontos da folha: contíguos na ordem de Morton
+      sources.x.insert(sources.x.end(), m_sortedX.begin() + cell.begin,
+                       m_sortedX.begin() + cell.end);
+      sources.y.insert(sources.y.end(), m_sortedY.begin() + cell.begin,
+                       m_sortedY.begin() + cell.end);
+      sources.mass.insert(sources.mass.end(), cell.end - cell.begin, 1.0f);
+      continue;
+    }
+
+    // Distância do centro de massa ao ponto mais próximo da caixa do grupo
+    auto const delta{glm::max(glm::max(low - cell.centerOfMass,
+                                       cell.centerOfMass - high),
+                              glm::vec2{0.0f})};
+    auto const distance2{glm::dot(delta, delta)};
+    if (cell.size * cell.size < theta2 * distance2) {
+      // Célula distante de todo o grupo: toda a massa no centro de massa
+      sources.x.push_back(cell.centerOfMass.x);
+      sources.y.push_back(cell.centerOfMass.y);
+      sources.mass.push_back(cell.mass);
+    } else {
+      for (std::uint32_t child = 0; child < 4; ++child) {
+        stack[top++] = cell.firstChild + child;
+      }
+    }
+  }
+}
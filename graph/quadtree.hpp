@@ -0,0 +1,104 @@
+// quadtree.hpp
+
+#ifndef QUADTREE_HPP_
+#define QUADTREE_HPP_
+
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <span>
+#include <vector>
+
+#include "threadpool.hpp"
+
+// Fontes de repulsão sobre um ponto, em estrutura de arrays: pontos das
+// folhas próximas (massa 1) e centros de massa das células distantes
+struct RepulsionSources {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> mass;
+
+  [[nodiscard]] std::size_t size() const { return x.size(); }
+  void clear() {
+    x.clear();
+    y.clear();
+    mass.clear();
+  }
+};
+
+// Quadtree de Barnes–Hut sobre pontos de massa unitária. Cada célula guarda a
+// massa e o centro de massa dos seus pontos, de modo que a repulsão de um
+// grupo distante é aproximada por um único termo e o custo por ponto cai de
+// O(n) para O(log n). As folhas agrupam até m_leafSize pontos, somados
+// diretamente. Em vez de somar as forças durante o percurso, a árvore lista
+// em RepulsionSources as fontes de um grupo de pontos consecutivos na ordem
+// de Morton, somadas depois para cada ponto do grupo por um kernel SIMD
+// (layoutkernels.hpp). Um único percurso serve a todo o grupo.
+//
+// Os pontos são ordenados pelo código de Morton (bits de x e y intercalados)
+// com um radix sort paralelo. Nessa ordem cada célula é um intervalo contíguo
+// e as quatro filhas de uma célula são encontradas por busca binária no
+// próximo dígito de 2 bits, sem mover pontos. Os níveis de cima são
+// divididos sequencialmente até restarem subárvores de no máximo
+// m_taskSize pontos, construídas em paralelo; massas e centros de massa são
+// então acumulados de baixo para cima. A árvore não depende do número de
+// threads
+class QuadTree {
+public:
+  // Coordenadas em estrutura de arrays; no máximo 2^m_indexBits pontos
+  void build(std::span<float const> x, std::span<float const> y,
+             ThreadPool &pool);
+
+  // Índice original de cada ponto na ordem de Morton
+  [[nodiscard]] std::span<std::uint32_t const> order() const {
+    return m_order;
+  }
+
+  // Substitui `sources` pelas fontes de repulsão dos pontos de posições
+  // [begin, end) na ordem de Morton: os pontos das folhas abertas (incluindo
+  // os do próprio grupo, o que coincide com cada ponto à distância zero) e as
+  // células de lado s aproximadas pelo centro de massa quando s < theta * r,
+  // com r a distância do centro de massa à caixa que envolve o grupo
+  void collectSources(std::size_t begin, std::size_t end, float theta,
+                      RepulsionSources &sources) const;
+
+private:
+  struct Cell {
+    glm::vec2 centerOfMass{};
+    float mass{};
+    float size{};               // Lado da célula
+    std::uint32_t firstChild{}; // Quatro filhas contíguas; 0 nas folhas
+    std::uint32_t begin{};      // Pontos: m_sortedX/Y[begin, end)
+    std::uint32_t end{};
+  };
+
+  void sortPoints(std::span<float const> x, std::span<float const> y,
+                  ThreadPool &pool);
+  void splitCell(std::vector<Cell> &cells, std::size_t cell, int depth) const;
+  void buildSubtree(std::vector<Cell> &cells, std::size_t cell,
+                    int depth) const;
+  void setLeaf(Cell &cell) const;
+  static void mergeChildren(std::span<Cell> cells, Cell &parent);
+
+  static constexpr std::uint32_t m_leafSize{8};
+  // Bits por eixo do código de Morton, que limitam a profundidade (e evitam
+  // divisões sem fim quando há pontos coincidentes)
+  static constexpr int m_maxDepth{20};
+  // O índice do ponto ocupa os bits baixos da chave ordenada
+  static constexpr int m_indexBits{24};
+  // Pontos por subárvore construída em paralelo
+  static constexpr std::uint32_t m_taskSize{4096};
+
+  float m_rootSize{};
+  std::vector<Cell> m_cells;
+  std::vector<std::uint64_t> m_codes; // Códigos de Morton, em ordem
+  std::vector<std::uint32_t> m_order;
+  std::vector<float> m_sortedX; // Coordenadas na ordem de Morton
+  std::vector<float> m_sortedY;
+
+  // Buffers reutilizados entre construções
+  std::vector<std::uint64_t> m_keys;
+  std::vector<std::uint64_t> m_buffer;
+  std::vector<std::vector<Cell>> m_subtrees;
+};
+
+#endif
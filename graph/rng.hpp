@@ -0,0 +1,77 @@
+// rng.hpp
+
+#ifndef RNG_HPP_
+#define RNG_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+// Finalizador do SplitMix64: espalha os bits de x em 64 bits pseudoaleatórios
+constexpr std::uint64_t mix64(std::uint64_t x) {
+  x ^= x >> 30U;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27U;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31U;
+  return x;
+}
+
+// Gerador baseado em contador no estilo SplitMix64: o n-ésimo número do
+// fluxo `stream` da semente `seed` é mix64(chave + (n + 1) * phi), em que a
+// chave é derivada de (seed, stream). Qualquer posição do fluxo é calculada
+// em O(1) e fluxos distintos são independentes, de modo que cada thread ou
+// bloco de trabalho usa o seu próprio fluxo e o resultado não depende da
+// ordem de execução. As conversões para intervalos são feitas aqui, e não
+// pelas distribuições da biblioteca padrão (cujos algoritmos variam entre
+// implementações), para que a mesma semente gere o mesmo grafo em qualquer
+// plataforma
+class CounterRng {
+public:
+  using result_type = std::uint64_t;
+
+  explicit CounterRng(std::uint64_t seed, std::uint64_t stream = 0)
+      : m_key{mix64(seed + mix64(stream + m_increment))} {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  // Número na posição `counter` do fluxo, sem alterar o estado
+  [[nodiscard]] result_type at(std::uint64_t counter) const {
+    return mix64(m_key + (counter + 1) * m_increment);
+  }
+
+  result_type operator()() { return at(m_counter++); }
+
+  // Real uniforme em [0, 1) com 53 bits de precisão
+  double uniform() { return toUnit((*this)()); }
+
+  float uniform(float low, float high) {
+    return low + static_cast<float>(uniform()) * (high - low);
+  }
+
+  // Inteiro uniforme em [0, bound), bound > 0
+  std::uint64_t below(std::uint64_t bound) {
+    return scale((*this)(), bound);
+  }
+
+  static double toUnit(result_type bits) {
+    return static_cast<double>(bits >> 11U) * 0x1.0p-53;
+  }
+
+  // Converte 64 bits uniformes em um inteiro de [0, bound)
+  static std::uint64_t scale(result_type bits, std::uint64_t bound) {
+    auto const value{toUnit(bits) * static_cast<double>(bound)};
+    return std::min(static_cast<std::uint64_t>(value), bound - 1);
+  }
+
+private:
+  static constexpr std::uint64_t m_increment{0x9E3779B97F4A7C15ULL};
+
+  std::uint64_t m_key;
+  std::uint64_t m_counter{0};
+};
+
+#endif
@@ -0,0 +1,162 @@
+// threadpool.cpp
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+
+namespace {
+constexpr std::uint64_t packRange(std::uint64_t begin, std::uint64_t end) {
+  return (begin << 32U) | end;
+}
+constexpr std::uint32_t rangeBegin(std::uint64_t range) {
+  return static_cast<std::uint32_t>(range >> 32U);
+}
+constexpr std::uint32_t rangeEnd(std::uint64_t range) {
+  return static_cast<std::uint32_t>(range);
+}
+} // namespace
+
+ThreadPool::ThreadPool(int numThreads) { resize(numThreads); }
+
+ThreadPool::~ThreadPool() { stop(); }
+
+void ThreadPool::resize(int numThreads) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  numThreads = 1;
+#endif
+  auto const count{static_cast<std::size_t>(std::max(numThreads, 1))};
+  if (m_queues != nullptr && count == m_workers.size() + 1) {
+    return;
+  }
+
+  stop();
+  m_queues = std::make_unique<Queue[]>(count);
+  m_stopping = false;
+  m_workers.reserve(count - 1);
+  for (std::size_t participant = 1; participant < count; ++participant) {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this, participant,
+                           m_generation);
+  }
+}
+
+void ThreadPool::stop() {
+  {
+    std::scoped_lock const lock{m_mutex};
+    m_stopping = true;
+  }
+  m_start.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+}
+
+void ThreadPool::run(std::size_t numChunks,
+                     std::function<void(std::size_t)> const &task) {
+  if (m_workers.empty() || numChunks == 1) {
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      task(chunk);
+    }
+    return;
+  }
+
+  // Distribui os blocos em intervalos de tamanhos iguais; participantes sem
+  // blocos começam roubando
+  {
+    std::scoped_lock const lock{m_mutex};
+    auto const count{static_cast<std::uint64_t>(threadCount())};
+    for (std::uint64_t participant = 0; participant < count; ++participant) {
+      m_queues[participant].range.store(
+          packRange(numChunks * participant / count,
+                    numChunks * (participant + 1) / count),
+          std::memory_order_relaxed);
+    }
+    m_task = &task;
+    m_busyWorkers = m_workers.size();
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  work(0);
+
+  // Nenhuma thread pode continuar lendo os intervalos desta chamada quando a
+  // próxima os redistribuir
+  std::unique_lock lock{m_mutex};
+  m_finish.wait(lock, [this] { return m_busyWorkers == 0; });
+  m_task = nullptr;
+}
+
+void ThreadPool::workerLoop(std::size_t participant,
+                            std::uint64_t generation) {
+  // `generation` é lida antes de a thread existir: uma chamada iniciada
+  // antes de a thread chegar à espera não pode ser perdida
+  while (true) {
+    {
+      std::unique_lock lock{m_mutex};
+      m_start.wait(lock, [&] {
+        return m_stopping || m_generation != generation;
+      });
+      if (m_stopping) {
+        return;
+      }
+      generation = m_generation;
+    }
+
+    work(participant);
+
+    {
+      std::scoped_lock const lock{m_mutex};
+      --m_busyWorkers;
+    }
+    m_finish.notify_one();
+  }
+}
+
+void ThreadPool::work(std::size_t participant) {
+  std::uint32_t chunk{};
+  while (popChunk(participant, chunk) || stealChunk(participant, chunk)) {
+    (*m_task)(chunk);
+  }
+}
+
+bool ThreadPool::popChunk(std::size_t participant, std::uint32_t &chunk) {
+  auto &queue{m_queues[participant].range};
+  auto range{queue.load(std::memory_order_acquire)};
+  while (rangeBegin(range) < rangeEnd(range)) {
+    if (queue.compare_exchange_weak(
+            range, packRange(rangeBegin(range) + 1ULL, rangeEnd(range)),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+      chunk = rangeBegin(range);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::stealChunk(std::size_t participant, std::uint32_t &chunk) {
+  // Um bloco nunca volta a um intervalo depois de tomado, então uma troca
+  // bem-sucedida sempre corresponde a blocos ainda pendentes
+  auto const count{static_cast<std::size_t>(threadCount())};
+  for (std::size_t offset = 1; offset < count; ++offset) {
+    auto &victim{m_queues[(participant + offset) % count].range};
+    auto range{victim.load(std::memory_order_acquire)};
+    while (rangeBegin(range) < rangeEnd(range)) {
+      auto const begin{rangeBegin(range)};
+      auto const end{rangeEnd(range)};
+      auto const middle{begin + (end - begin) / 2};
+      if (victim.compare_exchange_weak(range, packRange(begin, middle),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        // Executa o primeiro bloco roubado e guarda os demais no próprio
+        // intervalo, onde também podem ser roubados
+        chunk = middle;
+        if (middle + 1 < end) {
+          m_queues[participant].range.store(packRange(middle + 1ULL, end),
+                                            std::memory_order_release);
+        }
+        return true;
+      }
+    }
+  }
+  return false;
+}
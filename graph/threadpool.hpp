@@ -0,0 +1,78 @@
+// threadpool.hpp
+
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto persistente de threads com roubo de trabalho, para laços paralelos
+// executados muitas vezes por segundo (o layout de forças), em que criar
+// threads a cada chamada, como em parallelChunks, custaria mais que o próprio
+// trabalho. Cada participante recebe um intervalo contíguo de blocos e os
+// consome do início; quem esvazia o seu intervalo rouba a metade final do
+// intervalo de outro participante. As threads dormem entre as chamadas
+class ThreadPool {
+public:
+  explicit ThreadPool(int numThreads = 1);
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+
+  // Número de participantes, incluindo a thread que chama forEachChunk
+  void resize(int numThreads);
+  [[nodiscard]] int threadCount() const {
+    return static_cast<int>(m_workers.size()) + 1;
+  }
+
+  // Mesmo contrato de parallelChunks: divide [0, count) em `numChunks`
+  // blocos contíguos e executa fn(chunk, begin, end) para cada um. Os limites
+  // dependem apenas de `count` e `numChunks`, e não de qual thread executa
+  // cada bloco. Retorna quando todos os blocos terminam
+  template <typename Fn>
+  void forEachChunk(std::size_t count, std::size_t numChunks, Fn &&fn) {
+    if (numChunks == 0) {
+      return;
+    }
+    std::function<void(std::size_t)> const task{[&](std::size_t chunk) {
+      fn(chunk, count * chunk / numChunks, count * (chunk + 1) / numChunks);
+    }};
+    run(numChunks, task);
+  }
+
+private:
+  // Intervalo [begin, end) de blocos de um participante, empacotado em 64
+  // bits para ser tomado ou roubado com uma única troca atômica
+  struct alignas(64) Queue {
+    std::atomic<std::uint64_t> range{};
+  };
+
+  void run(std::size_t numChunks,
+           std::function<void(std::size_t)> const &task);
+  void work(std::size_t participant);
+  bool popChunk(std::size_t participant, std::uint32_t &chunk);
+  bool stealChunk(std::size_t participant, std::uint32_t &chunk);
+  void workerLoop(std::size_t participant, std::uint64_t generation);
+  void stop();
+
+  std::vector<std::thread> m_workers;
+  std::unique_ptr<Queue[]> m_queues;
+
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_finish;
+  std::uint64_t m_generation{};
+  std::size_t m_busyWorkers{};
+  bool m_stopping{false};
+  std::function<void(std::size_t)> const *m_task{};
+};
+
+#endif
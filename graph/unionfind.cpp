@@ -0,0 +1,47 @@
+// unionfind.cpp
+
+#include "unionfind.hpp"
+
+#include <numeric>
+#include <utility>
+
+void UnionFind::reset(int numNodes) {
+  auto const n{static_cast<std::size_t>(numNodes)};
+
+  // Cada nó começa na sua própria componente
+  m_parent.resize(n);
+  std::iota(m_parent.begin(), m_parent.end(), 0);
+  m_rank.assign(n, 0);
+  m_componentCount = numNodes;
+}
+
+int UnionFind::find(int node) {
+  // Compressão de caminho por divisão ao meio (path halving): cada nó
+  // visitado passa a apontar para o avô, sem recursão
+  auto index{static_cast<std::size_t>(node)};
+  while (m_parent[index] != static_cast<int>(index)) {
+    auto const parent{static_cast<std::size_t>(m_parent[index])};
+    m_parent[index] = m_parent[parent];
+    index = static_cast<std::size_t>(m_parent[index]);
+  }
+  return static_cast<int>(index);
+}
+
+bool UnionFind::unite(int nodeA, int nodeB) {
+  auto rootA{static_cast<std::size_t>(find(nodeA))};
+  auto rootB{static_cast<std::size_t>(find(nodeB))};
+  if (rootA == rootB)
+    return false;
+
+  // União por posto: a árvore mais baixa é pendurada na mais alta
+  if (m_rank[rootA] < m_rank[rootB]) {
+    std::swap(rootA, rootB);
+  }
+  m_parent[rootB] = static_cast<int>(rootA);
+  if (m_rank[rootA] == m_rank[rootB]) {
+    ++m_rank[rootA];
+  }
+
+  --m_componentCount;
+  return true;
+}
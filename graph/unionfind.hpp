@@ -0,0 +1,31 @@
+// unionfind.hpp
+
+#ifndef UNIONFIND_HPP_
+#define UNIONFIND_HPP_
+
+#include <cstdint>
+#include <vector>
+
+// Conjuntos disjuntos (union-find) com compressão de caminho e união por
+// posto. Mantém as componentes conexas à medida que as arestas são inseridas,
+// respondendo consultas em O(α(n)) amortizado. Remoções não são suportadas:
+// nesse caso basta chamar reset() e reinserir as arestas restantes
+class UnionFind {
+public:
+  void reset(int numNodes);
+  int find(int node);
+  bool unite(int nodeA, int nodeB);
+
+  [[nodiscard]] int componentCount() const { return m_componentCount; }
+  [[nodiscard]] bool isConnected() const { return m_componentCount <= 1; }
+
+  // Identificador da componente: o representante do conjunto do nó
+  int componentId(int node) { return find(node); }
+
+private:
+  std::vector<int> m_parent;
+  std::vector<std::uint8_t> m_rank;
+  int m_componentCount{};
+};
+
+#endif
@@ -2,16 +2,58 @@
 
 #include "window.hpp"
 
-#include <glm/gtc/constants.hpp>
+#include "abcgEmbeddedFonts.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <glm/common.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <imgui.h>
+#include <limits>
+#include <new>
 #include <random>
-#include <stack>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
+namespace {
+// Fluxos da semente usados por cada etapa da geração. Os geradores paralelos
+// recebem uma semente própria, sorteada do fluxo das arestas
+constexpr std::uint64_t positionStream{0};
+constexpr std::uint64_t edgeStream{1};
+constexpr std::uint64_t pivotStream{2};
+
+// Envia as arestas ao GL_ELEMENT_ARRAY_BUFFER vinculado como pares de
+// índices do tipo Index
+template <typename Index> void uploadEdgeIndices(std::span<Edge const> edges) {
+  std::vector<Index> indices;
+  indices.reserve(edges.size() * 2);
+  for (auto const &edge : edges) {
+    indices.push_back(static_cast<Index>(edge.nodeA));
+    indices.push_back(static_cast<Index>(edge.nodeB));
+  }
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(indices.size() * sizeof(Index)),
+               indices.data(), GL_STATIC_DRAW);
+}
+
+// Projeção ortográfica em que a menor dimensão de `size` corresponde a 2
+// unidades do mundo, centrada na origem
+glm::mat4 aspectProjection(glm::ivec2 size) {
+  auto const aspectRatio{static_cast<float>(size.x) /
+                         static_cast<float>(size.y)};
+  if (aspectRatio >= 1.0f) {
+    // Mais largo que alto
+    return glm::ortho(-aspectRatio, aspectRatio, -1.0f, 1.0f);
+  }
+  // Mais alto que largo
+  return glm::ortho(-1.0f, 1.0f, -1.0f / aspectRatio, 1.0f / aspectRatio);
+}
+} // namespace
+
 void Window::onCreate() {
   // Carrega os shaders para nós e arestas
   auto const assetsPath{abcg::Application::getAssetsPath()};
@@ -27,30 +69,41 @@ void Window::onCreate() {
   m_program = abcg::createOpenGLProgram({vertexShader, fragmentShader});
 
   // Adquire as localizações uniformes para o shader
-  m_colorLoc = glGetUniformLocation(m_program, "color");
-  m_translationLoc = glGetUniformLocation(m_program, "translation");
-  m_scaleLoc = glGetUniformLocation(m_program, "scale");
   m_projMatrixLoc = glGetUniformLocation(m_program, "projMatrix");
+  m_pixelsPerUnitLoc = glGetUniformLocation(m_program, "pixelsPerUnit");
+  m_outlineColorLoc = glGetUniformLocation(m_program, "outlineColor");
+  m_outlineWidthLoc = glGetUniformLocation(m_program, "outlineWidth");
+
+  // Programa das arestas: apenas projeção e cor constante
+  m_edgeProgram = abcg::createOpenGLProgram(
+      {{.source = assetsPath + "edge.vert", .stage = abcg::ShaderStage::Vertex},
+       {.source = assetsPath + "edge.frag",
+        .stage = abcg::ShaderStage::Fragment}});
+  m_edgeProjMatrixLoc = glGetUniformLocation(m_edgeProgram, "projMatrix");
+  m_edgeColorLoc = glGetUniformLocation(m_edgeProgram, "color");
 
   // Cria nós e arestas
-  createNodes();
-  createEdges();
-  computeNodeDegrees();
   setupModel();
+  generateGraph();
 
   // Define a cor do plano de fundo para branco
   glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
-  // Carrega a textura da fonte
-  abcg::OpenGLTextureCreateInfo textureInfo{.path = assetsPath + "font.png",
-                                            .generateMipmaps = false,
-                                            .flipUpsideDown = false};
-  m_fontTexture = abcg::loadOpenGLTexture(textureInfo);
+  // Gera o atlas SDF dos glifos a partir da fonte embutida na ABCg
+  if (!m_glyphAtlas.build(INCONSOLATA_MEDIUM_TTF)) {
+    throw abcg::RuntimeError("Failed to build the glyph atlas");
+  }
 
-  // Define parâmetros de textura
+  // Textura de um canal; a filtragem linear interpola as distâncias
+  glGenTextures(1, &m_fontTexture);
   glBindTexture(GL_TEXTURE_2D, m_fontTexture);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_glyphAtlas.width(),
+               m_glyphAtlas.height(), 0, GL_RED, GL_UNSIGNED_BYTE,
+               m_glyphAtlas.pixels().data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -77,171 +130,172 @@ void Window::onCreate() {
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  // Inicializa dados de caracteres e define a renderização de texto VAO/VBO
-  initCharacters();
+  // Define a renderização de texto VAO/VBO
   setupTextRendering();
 }
 
-void Window::initCharacters() {
-  // Define as coordenadas de textura para cada dígito (0-9)
-  // Cada número tem 10x20 pixels de proporção em uma textura 64x64
-  const float charWidth = 10.0f / 64.0f;
-  const float charHeight = 20.0f / 64.0f;
-
-  for (int i = 0; i < 10; ++i) {
-    float x = (i % 6) * charWidth;  // 6 números na primeira fileira
-    float y = (i / 6) * charHeight; // O restante na segunda fileira
-
-    // Ajusta as coordenadas de textura em sentido horário do canto inferior
-    // esquerdo
-    m_characters[i].texCoords[0] = {x, y};             // Bottom-left
-    m_characters[i].texCoords[1] = {x + charWidth, y}; // Bottom-right
-    m_characters[i].texCoords[2] = {x + charWidth, y + charHeight}; // Top-right
-    m_characters[i].texCoords[3] = {x, y + charHeight};             // Top-left
-
-    m_characters[i].advance = 0.1f; // Normaliza o avanço de largura
-  }
-}
-
 void Window::setupTextRendering() {
+  // Quadrado [0, 1]² desenhado como GL_TRIANGLE_STRIP, um por glifo
+  std::array const corners{glm::vec2{0.0f, 0.0f}, glm::vec2{1.0f, 0.0f},
+                           glm::vec2{0.0f, 1.0f}, glm::vec2{1.0f, 1.0f}};
+
   glGenVertexArrays(1, &m_VAO_text);
+  glGenBuffers(1, &m_VBO_textCorners);
   glGenBuffers(1, &m_VBO_text);
 
   glBindVertexArray(m_VAO_text);
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_text);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr,
-               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_textCorners);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners.data(),
+               GL_STATIC_DRAW);
+  glEnableVertexAttribArray(0); // Canto do quadrado
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
-  // Atributos do vértice
-  glEnableVertexAttribArray(0); // Posição
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
+  // Um registro por glifo de todos os rótulos, enviado por updateLabels()
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_text);
+  glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
 
-  glEnableVertexAttribArray(1); // Coordenada da textura
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat),
-                        (void *)(2 * sizeof(GLfloat)));
+  auto const stride{static_cast<GLsizei>(sizeof(GlyphInstance))};
+  auto const attribute{[stride](GLuint location, GLint size,
+                                std::size_t offset) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void *>(offset));
+    glVertexAttribDivisor(location, 1);
+  }};
+  attribute(1, 2, offsetof(GlyphInstance, anchor));  // Posição do nó
+  attribute(2, 2, offsetof(GlyphInstance, offset));  // Canto do glifo
+  attribute(3, 2, offsetof(GlyphInstance, size));    // Tamanho do glifo
+  attribute(4, 4, offsetof(GlyphInstance, texRect)); // Retângulo na textura
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
 }
 
-void Window::renderText(std::string text, glm::vec2 position) {
-  float scale = 0.05f; // Tamanho dos números (texto)
-
-  // Centraliza o texto em relação à posição dos nós
-  float textWidth = text.length() * scale;
-  float xOffset = -textWidth / 2.0f;
-  float yOffset = -scale;
-
-  std::vector<GLfloat> vertices;
-
-  float x = position.x + xOffset;
-  float y = position.y + yOffset;
-
-  for (char c : text) {
-    if (c < '0' || c > '9')
-      continue;
-
-    Character ch = m_characters[c - '0'];
+void Window::cacheLabelRuns(std::size_t count) {
+  // Os rótulos são os índices dos nós e não mudam, então a sequência de
+  // glifos do rótulo de cada nó é montada uma única vez e reaproveitada
+  float const scale{0.12f}; // Altura da linha dos rótulos
+  if (m_labelRunStart.empty()) {
+    m_labelRunStart.push_back(0);
+  }
 
-    float w = scale;
-    float h = scale * 2.0f; // Mantém o aspect ratio 1:2
+  for (auto id{m_labelRunStart.size() - 1}; id < count; ++id) {
+    auto const text{std::to_string(id)};
 
-    // Define os vértices quad com as coordenadas corretas da textura
-    GLfloat quadVertices[] = {
-        // Posições        // Coordenadas de textura
-        x,     y + h, ch.texCoords[0].x, ch.texCoords[0].y, // Superior-esquerda
-        x + w, y + h, ch.texCoords[1].x, ch.texCoords[1].y, // Superior-direita
-        x + w, y,     ch.texCoords[2].x, ch.texCoords[2].y, // inferior-direita
+    // Centraliza o texto em relação à posição do nó
+    auto x{-m_glyphAtlas.textWidth(text) / 2.0f};
+    auto const y{m_glyphAtlas.baseline()};
 
-        x,     y + h, ch.texCoords[0].x, ch.texCoords[0].y, // Superior-esquerda
-        x + w, y,     ch.texCoords[2].x, ch.texCoords[2].y, // Inferior-direita
-        x,     y,     ch.texCoords[3].x, ch.texCoords[3].y  // Inferior-esquerda
-    };
+    for (char c : text) {
+      auto const &glyph{m_glyphAtlas.glyph(c)};
+      if (glyph.size.x > 0.0f) {
+        m_labelGlyphs.push_back(
+            {.offset = (glm::vec2{x, y} + glyph.offset) * scale,
+             .size = glyph.size * scale,
+             .texRect = glyph.texRect});
+      }
+      x += glyph.advance; // Avança o cursor
+    }
+    m_labelRunStart.push_back(m_labelGlyphs.size());
+  }
+}
 
-    vertices.insert(vertices.end(), std::begin(quadVertices),
-                    std::end(quadVertices));
-    x += w; // Avança o cursor
+void Window::updateLabels() {
+  cacheLabelRuns(m_nodes.size());
+
+  // Cada glifo recebe a posição atual do seu nó
+  std::vector<GlyphInstance> instances;
+  instances.reserve(m_labelRunStart[m_nodes.size()]);
+  for (std::size_t id = 0; id < m_nodes.size(); ++id) {
+    for (auto g{m_labelRunStart[id]}; g < m_labelRunStart[id + 1]; ++g) {
+      auto const &glyph{m_labelGlyphs[g]};
+      instances.push_back({.anchor = m_nodes.position(id),
+                           .offset = glyph.offset,
+                           .size = glyph.size,
+                           .texRect = glyph.texRect});
+    }
   }
 
-  // Atualiza os dados do vértice
   glBindBuffer(GL_ARRAY_BUFFER, m_VBO_text);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat),
-               vertices.data(), GL_DYNAMIC_DRAW);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(instances.size() *
+                                       sizeof(GlyphInstance)),
+               instances.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-  // Desenha o texto
-  glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / 4));
+  m_labelGlyphCount = static_cast<GLsizei>(instances.size());
+  m_labelsDirty = false;
 }
 
 void Window::onPaint() {
-  // Limpar o buffer de cor
-  glClear(GL_COLOR_BUFFER_BIT);
-
-  // Calcular a proporção de aspecto
-  auto const aspectRatio = static_cast<float>(m_viewportSize.x) /
-                           static_cast<float>(m_viewportSize.y);
-
-  // Calcular a matriz de projeção
-  if (aspectRatio >= 1.0f) {
-    // Mais largo que alto
-    m_projMatrix = glm::ortho(-aspectRatio, aspectRatio, -1.0f, 1.0f);
-  } else {
-    // Mais alto que largo
-    m_projMatrix =
-        glm::ortho(-1.0f, 1.0f, -1.0f / aspectRatio, 1.0f / aspectRatio);
+  // Exportação pedida pela interface no quadro anterior
+  if (m_posterRequested) {
+    m_posterRequested = false;
+    exportPoster();
   }
 
-  glUseProgram(m_program);
-
-  // Definir a matriz de projeção
-  glUniformMatrix4fv(m_projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
+  m_projMatrix = aspectProjection(m_viewportSize);
 
-  // Desenhar arestas (linhas)
-  glUniform3f(m_colorLoc, 0.0f, 0.0f, 0.0f); // Cor das arestas (preto)
-  glUniform1f(m_scaleLoc, 1.0f);             // Sem escala para linhas
-  glUniform2f(m_translationLoc, 0.0f, 0.0f); // Sem translação para linhas
+  // Na projeção ortográfica a menor dimensão da janela corresponde a 2
+  // unidades do mundo
+  paintGraph(static_cast<float>(std::min(m_viewportSize.x, m_viewportSize.y)) /
+             2.0f);
+}
 
-  // Preparar dados para as arestas
-  std::vector<glm::vec2> edgePositions;
-  for (const auto &edge : m_edges) {
-    glm::vec2 posA = m_nodes[edge.nodeA].position;
-    glm::vec2 posB = m_nodes[edge.nodeB].position;
+void Window::paintGraph(float pixelsPerUnit) {
+  // Limpar o buffer de cor
+  glClear(GL_COLOR_BUFFER_BIT);
 
-    edgePositions.push_back(posA);
-    edgePositions.push_back(posB);
+  // Reenviar dados apenas se mudaram desde o último quadro
+  if (m_geometryDirty) {
+    updateGeometry();
+  } else if (m_positionsDirty) {
+    updatePositions();
+  }
+  if (m_instancesDirty) {
+    updateNodeInstances();
   }
 
-  glBindVertexArray(m_VAO_edges);
-  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_edges);
-  glBufferData(GL_ARRAY_BUFFER, edgePositions.size() * sizeof(glm::vec2),
-               edgePositions.data(), GL_DYNAMIC_DRAW);
+  // Cada etapa é uma zona do perfil de GPU (janela de FPS)
+  auto &profiler{getProfiler()};
 
-  glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(edgePositions.size()));
+  // Desenhar arestas (linhas pretas)
+  profiler.beginZone("Arestas");
+  glUseProgram(m_edgeProgram);
+  glUniformMatrix4fv(m_edgeProjMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
+  glUniform3f(m_edgeColorLoc, 0.0f, 0.0f, 0.0f);
 
-  // Desvincular
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(m_VAO_edges);
+  glDrawElements(GL_LINES, m_edgeIndexCount, m_edgeIndexType, nullptr);
   glBindVertexArray(0);
+  profiler.endZone();
 
-  // Desenhar nós
-  glUniform3f(m_colorLoc, m_nodeColor.r, m_nodeColor.g, m_nodeColor.b);
-  glUniform1f(m_scaleLoc, m_nodeRadius);
+  // Habilita blending para as bordas suavizadas dos nós e para o texto
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  glBindVertexArray(m_VAO_nodes);
+  // Desenhar nós: um quadrado por nó em uma única chamada de desenho
+  // instanciada; o círculo é recortado no fragment shader
+  profiler.beginZone("Nós");
+  glUseProgram(m_program);
+  glUniformMatrix4fv(m_projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
+  glUniform1f(m_pixelsPerUnitLoc, pixelsPerUnit);
+  glUniform3f(m_outlineColorLoc, m_outlineColor.r, m_outlineColor.g,
+              m_outlineColor.b);
+  glUniform1f(m_outlineWidthLoc, m_nodeOutline ? m_outlineWidth : 0.0f);
 
-  for (const auto &node : m_nodes) {
-    glUniform2f(m_translationLoc, node.position.x, node.position.y);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, m_circlePoints + 2);
-  }
+  glBindVertexArray(m_VAO_nodes);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                        static_cast<GLsizei>(m_nodes.size()));
 
   // Desvincular
   glBindVertexArray(0);
   glUseProgram(0);
-
-  // Habilita blending para texto
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  profiler.endZone();
 
   // Define renderização do texto
+  profiler.beginZone("Rótulos");
   glUseProgram(m_textProgram);
   glUniformMatrix4fv(m_textProjMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
   glUniform3f(m_textColorLoc, 0.0f, 0.0f, 0.0f); // Black text
@@ -249,12 +303,16 @@ void Window::onPaint() {
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, m_fontTexture);
 
-  glBindVertexArray(m_VAO_text);
-
-  // Renderiza os rótulos dos nós
-  for (size_t i = 0; i < m_nodes.size(); ++i) {
-    renderText(std::to_string(i), m_nodes[i].position);
+  // Renderiza os rótulos dos nós em uma única chamada de desenho, um
+  // quadrado instanciado por glifo (omitidos no modo de grafos grandes)
+  if (!m_largeGraphMode) {
+    if (m_labelsDirty) {
+      updateLabels();
+    }
+    glBindVertexArray(m_VAO_text);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_labelGlyphCount);
   }
+  profiler.endZone();
 
   // Limpeza
   glBindVertexArray(0);
@@ -262,6 +320,62 @@ void Window::onPaint() {
   glDisable(GL_BLEND);
 }
 
+void Window::updateGeometry() {
+  updatePositions();
+
+  // Um par de índices de nós por aresta, com índices de 16 bits sempre que
+  // todos os nós cabem neles. O buffer de elementos faz parte do estado do VAO
+  glBindVertexArray(m_VAO_edges);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_edges);
+  if (m_nodes.size() <= std::numeric_limits<GLushort>::max()) {
+    uploadEdgeIndices<GLushort>(m_edges);
+    m_edgeIndexType = GL_UNSIGNED_SHORT;
+  } else {
+    uploadEdgeIndices<GLuint>(m_edges);
+    m_edgeIndexType = GL_UNSIGNED_INT;
+  }
+  m_edgeIndexCount = static_cast<GLsizei>(m_edges.size() * 2);
+  glBindVertexArray(0);
+
+  m_geometryDirty = false;
+  m_instancesDirty = true;
+}
+
+void Window::updatePositions() {
+  // Posições dos nós: compartilhadas pelos nós (atributo por instância) e
+  // pelas arestas (vértices indexados). Mudam a cada quadro enquanto o
+  // layout de forças está em execução
+  std::vector<glm::vec2> positions;
+  positions.reserve(m_nodes.size());
+  for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+    positions.push_back(m_nodes.position(i));
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_positions);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(positions.size() * sizeof(glm::vec2)),
+               positions.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  m_positionsDirty = false;
+  m_labelsDirty = true;
+}
+
+void Window::updateNodeInstances() {
+  // Raio e cor de cada nó, um registro por instância
+  std::vector<NodeInstance> instances(m_nodes.size(),
+                                      {m_nodeRadius, m_nodeColor});
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_instances);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(instances.size() *
+                                       sizeof(NodeInstance)),
+               instances.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  m_instancesDirty = false;
+}
+
 void Window::onPaintUI() {
 #ifdef __EMSCRIPTEN__
   ImGui::Begin("Fullscreen", nullptr,
@@ -296,6 +410,71 @@ void Window::onPaintUI() {
 
   // Mostra o contador de FPS
   ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+
+  // Limite de quadros por segundo (0 = sem limite), para dividir a CPU de
+  // forma previsível entre várias instâncias no mesmo computador
+  auto targetFrameRate{getWindowSettings().targetFrameRate};
+  ImGui::PushItemWidth(100);
+  if (ImGui::InputInt("Limite de FPS", &targetFrameRate, 10)) {
+    auto settings{getWindowSettings()};
+    settings.targetFrameRate = std::clamp(targetFrameRate, 0, 1000);
+    setWindowSettings(settings);
+  }
+  ImGui::PopItemWidth();
+  if (targetFrameRate > 0) {
+    auto const &pacing{getFramePacingStats()};
+    ImGui::Text("Erro de Ritmo: %.2f ms (máx. %.2f ms)",
+                pacing.meanError * 1000.0, pacing.maxError * 1000.0);
+  }
+
+  // Perfil de GPU: tempo de GPU e de CPU de cada quadro e de cada etapa do
+  // desenho, lidos com alguns quadros de atraso para não bloquear o pipeline
+  auto &profiler{getProfiler()};
+  if (auto enabled{profiler.isEnabled()};
+      ImGui::Checkbox("Perfil da GPU", &enabled)) {
+    profiler.setEnabled(enabled);
+  }
+  if (profiler.isEnabled()) {
+    ImGui::Text("GPU: %.2f ms, CPU: %.2f ms", profiler.getGPUFrameTime(),
+                profiler.getCPUFrameTime());
+    for (auto const &zone : profiler.getZoneTimings()) {
+      ImGui::Text("%*s%s: %.3f ms", 2 * (zone.depth + 1), "",
+                  zone.name.c_str(), zone.averageTime);
+    }
+  }
+
+  // Gravação dos quadros (sem a interface) em Y4M, RGBA bruto ou PNGs
+  // numerados. Quadros são descartados se a escrita não acompanhar
+  ImGui::Separator();
+  if (!isCapturing()) {
+    static constexpr std::array captureFormats{"Y4M", "RGBA bruto", "PNGs"};
+    ImGui::PushItemWidth(100);
+    ImGui::Combo("Formato", &m_captureFormat, captureFormats.data(),
+                 static_cast<int>(captureFormats.size()));
+    ImGui::PopItemWidth();
+    ImGui::PushItemWidth(200);
+    ImGui::InputText("Arquivo", m_capturePath.data(), m_capturePath.size());
+    ImGui::PopItemWidth();
+    if (ImGui::Button("Gravar")) {
+      try {
+        startCapture(
+            {.format = static_cast<abcg::CaptureFormat>(m_captureFormat),
+             .path = m_capturePath.data(),
+             .frameRate = targetFrameRate > 0 ? targetFrameRate : 60});
+      } catch (abcg::Exception const &exception) {
+        fmt::print("{}\n", exception.what());
+      }
+    }
+  } else if (ImGui::Button("Parar")) {
+    stopCapture();
+  }
+  if (auto const stats{getCaptureStats()}; stats.capturedFrames > 0 ||
+                                            stats.droppedFrames > 0) {
+    ImGui::Text("Quadros: %d gravados, %d descartados", stats.writtenFrames,
+                stats.droppedFrames);
+    ImGui::Text("Fila: %d/%d%s", stats.queueDepth, stats.queueSize,
+                stats.writeError ? " (erro de escrita)" : "");
+  }
 #endif
 
   ImGui::End();
@@ -309,50 +488,338 @@ void Window::onPaintUI() {
   ImGui::Begin("Configurações do Grafo", nullptr,
                ImGuiWindowFlags_AlwaysAutoResize);
 
+  // Modo de grafos grandes. O grafo é gerado novamente ao trocar de modo:
+  // um grafo grande carregado travaria o caminho de desenho do modo normal,
+  // que lista todas as adjacências e monta os rótulos de todos os nós
+  if (ImGui::Checkbox("Modo de Grafos Grandes", &m_largeGraphMode)) {
+    if (!m_largeGraphMode) {
+      m_numNodes = std::min(m_numNodes, m_maxSmallNodes);
+      m_rmatScale = std::min(
+          m_rmatScale,
+          static_cast<int>(
+              std::bit_width(static_cast<unsigned>(m_maxSmallNodes))) -
+              1);
+    }
+    generateGraph();
+  }
+
   // Número de Nós
-  ImGui::SliderInt("Número de Nós", &m_numNodes, 1, 10);
+  if (m_largeGraphMode) {
+    ImGui::InputInt("Número de Nós", &m_numNodes, 1000, 100000);
+    m_numNodes = std::clamp(m_numNodes, 1, m_maxLargeNodes);
+  } else {
+    ImGui::SliderInt("Número de Nós", &m_numNodes, 1, m_maxSmallNodes);
+  }
 
   // Raio dos Nós
-  ImGui::SliderFloat("Raio dos Nós", &m_nodeRadius, 0.01f, 0.2f);
+  if (ImGui::SliderFloat("Raio dos Nós", &m_nodeRadius,
+                         m_largeGraphMode ? 0.001f : 0.01f, 0.2f, "%.3f",
+                         m_largeGraphMode ? ImGuiSliderFlags_Logarithmic
+                                          : ImGuiSliderFlags_None)) {
+    m_instancesDirty = true;
+  }
 
   // Cor dos Nós
-  ImGui::ColorEdit3("Cor dos Nós", &m_nodeColor.r);
+  if (ImGui::ColorEdit3("Cor dos Nós", &m_nodeColor.r)) {
+    m_instancesDirty = true;
+  }
+
+  // Contorno dos nós (anel desenhado no fragment shader)
+  ImGui::Checkbox("Contorno dos Nós", &m_nodeOutline);
+  if (m_nodeOutline) {
+    ImGui::ColorEdit3("Cor do Contorno", &m_outlineColor.r);
+    ImGui::SliderFloat("Espessura do Contorno", &m_outlineWidth, 0.05f, 0.5f,
+                       "%.2f");
+  }
 
-  // Opção para grafo conectado ou desconexo
-  ImGui::Checkbox("Grafo Conectado", &m_connectedGraph);
+  // Modelo de geração das arestas
+  std::array const modelNames{"Padrão", "Erdős–Rényi G(n,p)",
+                              "Erdős–Rényi G(n,m)", "Blocos Estocásticos",
+                              "Barabási–Albert", "R-MAT (Graph500)"};
+  auto modelIndex{static_cast<int>(m_graphModel)};
+  if (ImGui::Combo("Modelo", &modelIndex, modelNames.data(),
+                   static_cast<int>(modelNames.size()))) {
+    m_graphModel = static_cast<GraphModel>(modelIndex);
+  }
+
+  auto const pairs{static_cast<float>(maxEdgeCount(m_numNodes))};
+  switch (m_graphModel) {
+  case GraphModel::Default:
+    // Opção para grafo conectado ou desconexo
+    ImGui::Checkbox("Grafo Conectado", &m_connectedGraph);
+
+    // Número exato de arestas (limitado pelo número de pares possíveis)
+    ImGui::Checkbox("Número Exato de Arestas", &m_useTargetEdges);
+    if (m_useTargetEdges) {
+      // O grafo conectado já tem as n - 1 arestas do caminho entre os nós;
+      // o máximo é o do G(n, m)
+      auto const minEdges{m_connectedGraph ? std::max(m_numNodes - 1, 0) : 0};
+      auto const maxEdges{std::min(maxEdgeCount(m_numNodes), maxExpectedEdges)};
+      ImGui::InputInt("Arestas Alvo", &m_targetEdges, 1, 1000);
+      m_targetEdges = static_cast<int>(
+          std::clamp<std::int64_t>(m_targetEdges, minEdges, maxEdges));
+      if (m_connectedGraph) {
+        ImGui::Text("Mínimo de %d arestas (grafo conectado)", minEdges);
+      }
+      if (m_targetEdges == maxEdges) {
+        ImGui::Text("Limitado a %lld arestas",
+                    static_cast<long long>(maxEdges));
+      }
+    }
+    break;
+  case GraphModel::ErdosRenyiGnp:
+    ImGui::SliderFloat("Probabilidade p", &m_edgeProbability, 1e-7f, 1.0f,
+                       "%.2e", ImGuiSliderFlags_Logarithmic);
+    {
+      // Acima de maxExpectedEdges arestas esperadas, p é reduzido aqui
+      // (e no gerador), em vez de esgotar a memória
+      auto const limited{static_cast<float>(limitProbability(
+          maxEdgeCount(m_numNodes), m_edgeProbability))};
+      if (limited < m_edgeProbability) {
+        m_edgeProbability = limited;
+        ImGui::Text("p limitado a %lld arestas esperadas",
+                    static_cast<long long>(maxExpectedEdges));
+      }
+    }
+    ImGui::Text("Arestas Esperadas: %.0f", pairs * m_edgeProbability);
+    break;
+  case GraphModel::ErdosRenyiGnm: {
+    // Mesmo limite de arestas do G(n, p), aplicado também pelo gerador
+    auto const maxEdges{std::min(maxEdgeCount(m_numNodes), maxExpectedEdges)};
+    ImGui::InputInt("Arestas Alvo", &m_targetEdges, 1, 1000);
+    m_targetEdges = static_cast<int>(
+        std::clamp<std::int64_t>(m_targetEdges, 0, maxEdges));
+    if (m_targetEdges == maxEdges) {
+      ImGui::Text("Limitado a %lld arestas", static_cast<long long>(maxEdges));
+    }
+    break;
+  }
+  case GraphModel::StochasticBlock: {
+    ImGui::SliderInt("Blocos", &m_numBlocks, 1, 64);
+    ImGui::SliderFloat("p Interno", &m_blockProbabilityIn, 1e-7f, 1.0f,
+                       "%.2e", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("p Externo", &m_blockProbabilityOut, 0.0f, 1.0f,
+                       "%.2e", ImGuiSliderFlags_Logarithmic);
+    // Mesmo limite do G(n, p), reduzindo as duas probabilidades na mesma
+    // proporção, como stochasticBlockModel
+    auto expected{expectedBlockModelEdges(
+        m_numNodes, m_numBlocks, m_blockProbabilityIn, m_blockProbabilityOut)};
+    if (expected > static_cast<double>(maxExpectedEdges)) {
+      auto const scale{static_cast<double>(maxExpectedEdges) / expected};
+      m_blockProbabilityIn =
+          static_cast<float>(m_blockProbabilityIn * scale);
+      m_blockProbabilityOut =
+          static_cast<float>(m_blockProbabilityOut * scale);
+      expected = static_cast<double>(maxExpectedEdges);
+      ImGui::Text("p limitado a %lld arestas esperadas",
+                  static_cast<long long>(maxExpectedEdges));
+    }
+    ImGui::Text("Arestas Esperadas: %.0f", expected);
+    break;
+  }
+  case GraphModel::BarabasiAlbert:
+    ImGui::SliderInt("Arestas por Nó", &m_edgesPerNode, 1, 16);
+    ImGui::SliderInt("Threads", &m_numThreads, 1, 64);
+    break;
+  case GraphModel::RMat: {
+    // O número de nós é 2^escala, limitado pelo máximo do modo atual e pela
+    // memória da geração
+    auto const maxNodes{m_largeGraphMode ? m_maxLargeNodes : m_maxSmallNodes};
+    auto const nodeScale{
+        static_cast<int>(std::bit_width(static_cast<unsigned>(maxNodes))) - 1};
+    auto const maxScale{std::min(nodeScale, maxRMatScale(m_rmatEdgeFactor))};
+    m_rmatScale = std::min(m_rmatScale, maxScale);
+    ImGui::SliderInt("Escala (log2 n)", &m_rmatScale, 1, maxScale);
+    if (maxScale < nodeScale) {
+      ImGui::Text("Escala limitada a %d com %d arestas por nó (memória)",
+                  maxScale, m_rmatEdgeFactor);
+    }
+    ImGui::SliderInt("Arestas por Nó", &m_rmatEdgeFactor, 1, 64);
+    ImGui::SliderFloat("a", &m_rmatParameters.a, 0.0f, 1.0f);
+    ImGui::SliderFloat("b", &m_rmatParameters.b, 0.0f, 1.0f);
+    ImGui::SliderFloat("c", &m_rmatParameters.c, 0.0f, 1.0f);
+    auto const d{1.0f - m_rmatParameters.a - m_rmatParameters.b -
+                 m_rmatParameters.c};
+    ImGui::Text("d: %.2f%s", d, d < 0.0f ? " (a + b + c > 1)" : "");
+    ImGui::SliderInt("Threads", &m_numThreads, 1, 64);
+
+    // Geração direta para arquivo: não passa pelo grafo exibido. A escala
+    // é limitada pela memória da geração
+    auto const maxFileScale{maxRMatFileScale(m_rmatEdgeFactor)};
+    m_rmatFileScale = std::min(m_rmatFileScale, maxFileScale);
+    ImGui::SliderInt("Escala do Arquivo", &m_rmatFileScale, 1, maxFileScale);
+    if (maxFileScale < 30) {
+      ImGui::Text("Escala máxima %d com %d arestas por nó (memória)",
+                  maxFileScale, m_rmatEdgeFactor);
+    }
+    ImGui::InputText("Arquivo", m_edgeFilePath.data(), m_edgeFilePath.size());
+    ImGui::BeginDisabled(m_exportResult.valid());
+    if (ImGui::Button("Gravar R-MAT em Arquivo")) {
+      exportRMat();
+    }
+    ImGui::EndDisabled();
+    if (!m_exportStatus.empty()) {
+      ImGui::TextUnformatted(m_exportStatus.c_str());
+    }
+    break;
+  }
+  }
+
+  // Semente: com "Semente Fixa" o mesmo grafo é gerado novamente. Digitar
+  // uma semente a fixa
+  if (ImGui::InputScalar("Semente", ImGuiDataType_U64, &m_seed)) {
+    m_fixedSeed = true;
+  }
+  ImGui::Checkbox("Semente Fixa", &m_fixedSeed);
+
+  // Posições iniciais, usadas a partir do próximo grafo
+  std::array const placementNames{"Aleatórias", "Pivot-MDS"};
+  auto placementIndex{static_cast<int>(m_initialPlacement)};
+  if (ImGui::Combo("Posições Iniciais", &placementIndex,
+                   placementNames.data(),
+                   static_cast<int>(placementNames.size()))) {
+    m_initialPlacement = static_cast<InitialPlacement>(placementIndex);
+  }
+  if (m_initialPlacement == InitialPlacement::PivotMds) {
+    ImGui::SliderInt("Pivôs", &m_numPivots, 2, 100);
+    // A matriz de distâncias tem n · pivôs valores
+    auto const numNodes{m_graphModel == GraphModel::RMat ? 1 << m_rmatScale
+                                                         : m_numNodes};
+    if (m_numPivots > maxPivots(numNodes)) {
+      ImGui::Text("Limitado a %d pivôs com %d nós (memória)",
+                  maxPivots(numNodes), numNodes);
+    }
+  }
 
   // Botão para gerar um novo grafo
   if (ImGui::Button("Novo Grafo")) {
-    createNodes();
-    createEdges();
-    computeNodeDegrees();
+    generateGraph();
   }
 
-  ImGui::Separator();
+  // Layout de forças: algumas iterações por quadro, sem travar a interface
+  if (ImGui::CollapsingHeader("Layout de Forças")) {
+    if (ImGui::Checkbox("Executar Layout", &m_runLayout)) {
+      updateAnimation();
+    }
+    auto &settings{m_layout.settings()};
+    ImGui::SliderFloat("Theta (Barnes-Hut)", &settings.theta, 0.0f, 2.0f);
+    ImGui::SliderFloat("Repulsão", &settings.repulsion, 0.01f, 2.0f);
+    ImGui::SliderFloat("Gravidade", &settings.gravity, 0.0f, 0.1f);
+    ImGui::SliderInt("Threads do Layout", &settings.numThreads, 1, 64);
+    ImGui::Checkbox("Kernels SIMD", &settings.useSimd);
+    // A hierarquia de níveis é montada a partir das posições iniciais
+    if (ImGui::Checkbox("Multinível", &settings.multilevel)) {
+      resetLayout();
+    }
+    if (ImGui::Button("Reiniciar Layout")) {
+      resetLayout();
+    }
+    ImGui::Text("Iteração: %d%s", m_layout.iteration(),
+                m_layout.converged() ? " (convergiu)" : "");
+    if (m_layout.buildingHierarchy()) {
+      ImGui::Text("Nível: construindo a hierarquia...");
+    } else {
+      ImGui::Text("Nível: %d de %d (0 = grafo original)", m_layout.level(),
+                  m_layout.levelCount());
+    }
+    ImGui::Text("Deslocamento Médio: %.4f", m_layout.meanDisplacement());
+    ImGui::Text("Tempo por Iteração: %.2f ms", m_layout.iterationTime());
+    ImGui::Text("Kernels: %s", settings.useSimd
+                                   ? layoutKernels().name
+                                   : scalarLayoutKernels().name);
+    auto const &timings{m_layout.timings()};
+    ImGui::Text("Árvore: %.2f ms, Forças: %.2f ms, Integração: %.2f ms",
+                timings.tree, timings.forces, timings.integration);
+  }
+
+  // Pôster em alta resolução, desenhado em ladrilhos fora da tela e gravado
+  // em faixas de linhas: o tamanho não é limitado pela janela nem pelo
+  // framebuffer
+  if (ImGui::CollapsingHeader("Exportar Pôster")) {
+    if (ImGui::InputInt2("Tamanho (px)", &m_posterSize.x)) {
+      m_posterSize = glm::clamp(m_posterSize, 1, m_maxPosterSize);
+    }
+    ImGui::InputText("Arquivo do Pôster", m_posterPath.data(),
+                     m_posterPath.size());
+    if (ImGui::Button("Exportar PNG")) {
+      m_posterRequested = true;
+      requestRepaint();
+    }
+    if (!m_posterStatus.empty()) {
+      ImGui::TextUnformatted(m_posterStatus.c_str());
+    }
+  }
 
-  // Verificar se o grafo é conectado
-  bool connected = isGraphConnected();
+  ImGui::Separator();
 
+  // Estatísticas em cache: custo O(1) por quadro
   ImGui::Text("Informações do Grafo");
   ImGui::Text("Tipo do Grafo: Não Dirigido");
   ImGui::Text("Conectividade do Grafo: %s",
-              connected ? "Conectado" : "Desconexo");
-  ImGui::Text("Total de Nós: %d", m_numNodes);
-  ImGui::Text("Total de Arestas: %d", static_cast<int>(m_edges.size()));
-
-  // Calcular grau médio
-  int totalDegree = 0;
-  for (const auto &node : m_nodes) {
-    totalDegree += node.degree;
-  }
-  float averageDegree = static_cast<float>(totalDegree) / m_numNodes;
-  ImGui::Text("Grau Médio: %.2f", averageDegree);
+              m_components.isConnected() ? "Conectado" : "Desconexo");
+  ImGui::Text("Componentes Conexas: %d", m_components.componentCount());
+  ImGui::Text("Total de Nós: %zu", m_nodes.size());
+  ImGui::Text("Total de Arestas: %zu", m_edges.size());
+  ImGui::Text("Grau Médio: %.2f", m_averageDegree);
+  ImGui::Text("Grau Máximo: %d", m_maxDegree);
+  ImGui::Text("Tempo de Geração: %.1f ms", m_generationTime);
 
   ImGui::Separator();
 
+  if (m_largeGraphMode) {
+    // Apenas as linhas visíveis são submetidas ao ImGui (ImGuiListClipper)
+    auto const nodeCount{static_cast<int>(m_nodes.size())};
+    auto const listHeight{ImGui::GetTextLineHeightWithSpacing() * 10.0f};
+
+    ImGui::Text("Grau dos Nós:");
+    ImGui::BeginChild("degrees", ImVec2(360.0f, listHeight), true);
+    ImGuiListClipper degreeClipper;
+    degreeClipper.Begin(nodeCount);
+    while (degreeClipper.Step()) {
+      for (int i = degreeClipper.DisplayStart; i < degreeClipper.DisplayEnd;
+           ++i) {
+        ImGui::Text("Nó %d: %d (componente %d)", i,
+                    m_nodes.degree[static_cast<size_t>(i)],
+                    m_components.componentId(i));
+      }
+    }
+    ImGui::EndChild();
+
+    ImGui::Text("Lista de Adjacência:");
+    ImGui::BeginChild("adjacency", ImVec2(360.0f, listHeight), true,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+    ImGuiListClipper adjacencyClipper;
+    adjacencyClipper.Begin(nodeCount);
+    std::string line;
+    while (adjacencyClipper.Step()) {
+      for (int i = adjacencyClipper.DisplayStart;
+           i < adjacencyClipper.DisplayEnd; ++i) {
+        // Limita a quantidade de vizinhos formatados por linha
+        constexpr std::size_t maxListed{16};
+        auto const adjacentNodes{m_graph.neighbors(i)};
+        line = fmt::format("Nó {}:", i);
+        for (auto const neighbor :
+             adjacentNodes.first(std::min(adjacentNodes.size(), maxListed))) {
+          line += fmt::format(" {}", neighbor);
+        }
+        if (adjacentNodes.empty()) {
+          line += " Nenhum";
+        } else if (adjacentNodes.size() > maxListed) {
+          line += fmt::format(" ... (+{})", adjacentNodes.size() - maxListed);
+        }
+        ImGui::TextUnformatted(line.c_str());
+      }
+    }
+    ImGui::EndChild();
+
+    ImGui::End();
+    return;
+  }
+
   ImGui::Text("Grau dos Nós:");
   for (size_t i = 0; i < m_nodes.size(); ++i) {
-    ImGui::Text("Nó %zu: %d", i, m_nodes[i].degree);
+    ImGui::Text("Nó %zu: %d (componente %d)", i, m_nodes.degree[i],
+                m_components.componentId(static_cast<int>(i)));
   }
 
   ImGui::Separator();
@@ -363,15 +830,8 @@ void Window::onPaintUI() {
     ImGui::Text("Nó %zu:", i);
     ImGui::SameLine();
 
-    // Encontrar nós adjacentes
-    std::vector<int> adjacentNodes;
-    for (const auto &edge : m_edges) {
-      if (edge.nodeA == static_cast<int>(i)) {
-        adjacentNodes.push_back(edge.nodeB);
-      } else if (edge.nodeB == static_cast<int>(i)) {
-        adjacentNodes.push_back(edge.nodeA);
-      }
-    }
+    // Nós adjacentes lidos diretamente da estrutura CSR
+    auto const adjacentNodes{m_graph.neighbors(static_cast<int>(i))};
 
     if (adjacentNodes.empty()) {
       ImGui::Text(" Nenhum");
@@ -391,6 +851,65 @@ void Window::onPaintUI() {
   ImGui::End();
 }
 
+void Window::onUpdate() {
+  if (m_exportResult.valid() &&
+      m_exportResult.wait_for(std::chrono::seconds{0}) !=
+          std::future_status::timeout) {
+    m_exportStatus = m_exportResult.get();
+    updateAnimation();
+  }
+
+  if (!m_runLayout || m_layout.converged()) {
+    return;
+  }
+  if (m_layout.run(m_layoutBudget) > 0) {
+    applyLayout();
+  }
+  if (m_layout.converged()) {
+    updateAnimation();
+  }
+}
+
+void Window::updateAnimation() {
+  // Quadros contínuos enquanto o layout avança ou um arquivo é gravado
+  setAnimationActive((m_runLayout && !m_layout.converged()) ||
+                     m_exportResult.valid());
+}
+
+void Window::resetLayout() {
+  // Sem a hierarquia multinível, posições do Pivot-MDS só são refinadas: o
+  // resfriamento adaptativo partindo de um layout pronto demora a convergir
+  auto const refine{m_nodesPlacement == InitialPlacement::PivotMds &&
+                    !m_layout.settings().multilevel};
+  m_layout.reset(m_initialX, m_initialY, m_graph, refine);
+  m_nodes.x = m_initialX;
+  m_nodes.y = m_initialY;
+  m_positionsDirty = true;
+  updateAnimation();
+}
+
+void Window::applyLayout() { fitPositions(m_layout.x(), m_layout.y()); }
+
+void Window::fitPositions(std::span<float const> x,
+                          std::span<float const> y) {
+  // As posições do layout ocupam uma área proporcional ao número de nós;
+  // são ajustadas ao quadrado [-1 + r, 1 - r]² preservando a proporção
+  if (x.empty()) {
+    return;
+  }
+  auto const [lowX, highX]{std::minmax_element(x.begin(), x.end())};
+  auto const [lowY, highY]{std::minmax_element(y.begin(), y.end())};
+  glm::vec2 const center{(*lowX + *highX) * 0.5f, (*lowY + *highY) * 0.5f};
+  auto const extent{std::max(*highX - *lowX, *highY - *lowY)};
+  auto const scale{extent > 0.0f ? (2.0f - 2.0f * m_nodeRadius) / extent
+                                 : 0.0f};
+  for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+    m_nodes.x[i] = (x[i] - center.x) * scale;
+    m_nodes.y[i] = (y[i] - center.y) * scale;
+  }
+  m_positionsDirty = true;
+}
+
 void Window::onResize(const glm::ivec2 &size) {
   glViewport(0, 0, size.x, size.y);
   m_viewportSize = size;
@@ -398,183 +917,292 @@ void Window::onResize(const glm::ivec2 &size) {
 
 void Window::onDestroy() {
   glDeleteProgram(m_program);
+  glDeleteProgram(m_edgeProgram);
 
   glDeleteBuffers(1, &m_VBO_nodes);
+  glDeleteBuffers(1, &m_VBO_positions);
+  glDeleteBuffers(1, &m_VBO_instances);
   glDeleteVertexArrays(1, &m_VAO_nodes);
 
-  glDeleteBuffers(1, &m_VBO_edges);
+  glDeleteBuffers(1, &m_EBO_edges);
   glDeleteVertexArrays(1, &m_VAO_edges);
 
   glDeleteProgram(m_textProgram);
   glDeleteTextures(1, &m_fontTexture);
   glDeleteBuffers(1, &m_VBO_text);
+  glDeleteBuffers(1, &m_VBO_textCorners);
   glDeleteVertexArrays(1, &m_VAO_text);
 }
 
+void Window::generateGraph(std::uint64_t seed) {
+  m_seed = seed;
+  m_fixedSeed = true;
+  generateGraph();
+}
+
+void Window::generateGraph() {
+  abcg::Timer timer;
+
+  if (!m_fixedSeed) {
+    std::random_device rd;
+    m_seed = (std::uint64_t{rd()} << 32U) | rd();
+  }
+
+  if (m_graphModel == GraphModel::RMat) {
+    // As arestas por nó podem ter mudado depois da escala no mesmo quadro
+    m_rmatScale = std::min(m_rmatScale, maxRMatScale(m_rmatEdgeFactor));
+    m_numNodes = 1 << m_rmatScale;
+  }
+
+  // A hierarquia multinível pode estar sendo construída a partir do grafo
+  // atual, que será substituído
+  m_layout.stop();
+
+  createNodes();
+  createEdges();
+  placeNodes();
+
+  // Estatísticas são calculadas aqui, e não a cada quadro. A conectividade
+  // já foi mantida pelo union-find durante a inserção das arestas
+  std::size_t totalDegree{0};
+  m_maxDegree = 0;
+  for (auto const degree : m_nodes.degree) {
+    totalDegree += static_cast<std::size_t>(degree);
+    m_maxDegree = std::max(m_maxDegree, degree);
+  }
+  m_averageDegree = m_nodes.empty() ? 0.0f
+                                    : static_cast<float>(totalDegree) /
+                                          static_cast<float>(m_nodes.size());
+
+  m_geometryDirty = true;
+  m_generationTime = timer.elapsed() * 1000.0;
+
+  // O layout de forças parte das posições iniciais
+  resetLayout();
+}
+
 void Window::createNodes() {
-  // Gerar posições aleatórias para os nós
-  m_nodes.clear();
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<float> disX(-1.0f + m_nodeRadius,
-                                             1.0f - m_nodeRadius);
-  std::uniform_real_distribution<float> disY(-1.0f + m_nodeRadius,
-                                             1.0f - m_nodeRadius);
-
-  for (int i = 0; i < m_numNodes; ++i) {
-    Node node;
-    node.position = {disX(gen), disY(gen)};
-    m_nodes.push_back(node);
+  // Gerar posições aleatórias para os nós: as coordenadas do nó i são os
+  // números 2i e 2i + 1 do fluxo, então os blocos podem ser preenchidos em
+  // paralelo
+  m_nodes.assign(static_cast<std::size_t>(m_numNodes));
+  CounterRng const rng{m_seed, positionStream};
+  auto const low{-1.0f + m_nodeRadius};
+  auto const extent{2.0f - 2.0f * m_nodeRadius};
+  auto const coordinate{[&](std::uint64_t counter) {
+    return low + static_cast<float>(CounterRng::toUnit(rng.at(counter))) *
+                     extent;
+  }};
+
+  parallelChunks(m_nodes.size(),
+                 static_cast<std::size_t>(m_numThreads) * 16, m_numThreads,
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+                   for (auto i{begin}; i < end; ++i) {
+                     m_nodes.x[i] = coordinate(2 * i);
+                     m_nodes.y[i] = coordinate(2 * i + 1);
+                   }
+                 });
+}
+
+void Window::placeNodes() {
+  // As posições aleatórias de createNodes ficam quando a estratégia é
+  // "Aleatórias"; o Pivot-MDS precisa das arestas e vem depois delas
+  m_nodesPlacement = m_initialPlacement;
+  if (m_nodesPlacement == InitialPlacement::PivotMds) {
+    CounterRng rng{m_seed, pivotStream};
+    std::vector<float> x;
+    std::vector<float> y;
+    pivotMds(m_graph, m_numPivots, m_numThreads, rng, x, y);
+    fitPositions(x, y);
   }
+
+  // O layout sobrescreve m_nodes; "Reiniciar Layout" parte desta cópia
+  m_initialX = m_nodes.x;
+  m_initialY = m_nodes.y;
 }
 
 void Window::createEdges() {
   // Limpar arestas existentes
   m_edges.clear();
+  m_components.reset(static_cast<int>(m_nodes.size()));
+
+  CounterRng rng{m_seed, edgeStream};
+
+  switch (m_graphModel) {
+  case GraphModel::Default:
+    createDefaultEdges(rng);
+    break;
+  case GraphModel::ErdosRenyiGnp:
+    erdosRenyiGnp(0, m_numNodes, m_edgeProbability, m_edges, rng);
+    uniteEdges(0);
+    break;
+  case GraphModel::ErdosRenyiGnm:
+    erdosRenyiGnm(m_numNodes, m_targetEdges, m_edges, rng);
+    uniteEdges(0);
+    break;
+  case GraphModel::StochasticBlock:
+    stochasticBlockModel(m_numNodes, m_numBlocks, m_blockProbabilityIn,
+                         m_blockProbabilityOut, rng(), m_numThreads, m_edges);
+    uniteEdges(0);
+    break;
+  case GraphModel::BarabasiAlbert:
+    barabasiAlbertParallel(m_numNodes, m_edgesPerNode, rng(), m_numThreads,
+                           m_edges);
+    uniteEdges(0);
+    break;
+  case GraphModel::RMat:
+    rmat(m_rmatScale, m_rmatEdgeFactor, m_rmatParameters, rng(), m_numThreads,
+         m_edges);
+    uniteEdges(0);
+    break;
+  }
+
+  // Reconstruir a adjacência em CSR e recalcular graus dos nós
+  m_graph.build(static_cast<int>(m_nodes.size()), m_edges);
+  computeNodeDegrees();
+}
+
+void Window::exportPoster() {
+  abcg::Timer timer;
+
+  // Cada ladrilho é desenhado com a projeção do pôster inteiro restrita à
+  // sua região; a escala em pixels é a do pôster, não a do ladrilho
+  auto const size{m_posterSize};
+  auto const posterProjection{aspectProjection(size)};
+  auto const pixelsPerUnit{static_cast<float>(std::min(size.x, size.y)) /
+                           2.0f};
+  std::string const path{m_posterPath.data()};
+  try {
+    abcg::saveOpenGLPosterPNG(
+        {.path = path,
+         .size = size,
+         .paintTile = [&](glm::mat4 const &tileMatrix, glm::ivec2) {
+           m_projMatrix = tileMatrix * posterProjection;
+           paintGraph(pixelsPerUnit);
+         }});
+    m_posterStatus = fmt::format("{}x{} gravado em {:.1f} s", size.x, size.y,
+                                 timer.elapsed());
+  } catch (abcg::Exception const &exception) {
+    m_posterStatus = fmt::format("Falha ao gravar {}", path);
+    fmt::print("{}\n", exception.what());
+  }
+
+  // Mostra o resultado na interface
+  requestRepaint();
+}
+
+void Window::exportRMat() {
+  // Mesma semente derivada do grafo exibido: com a mesma escala, o arquivo
+  // contém exatamente as arestas do modelo R-MAT gerado na tela. A gravação
+  // roda em outra thread com cópias dos parâmetros, e o resultado é
+  // verificado em onUpdate
+  CounterRng rng{m_seed, edgeStream};
+  auto const seed{rng()};
+  std::string const path{m_edgeFilePath.data()};
+  auto const task{[path, scale = m_rmatFileScale,
+                   edgeFactor = m_rmatEdgeFactor, parameters = m_rmatParameters,
+                   seed, numThreads = m_numThreads]() -> std::string {
+    abcg::Timer timer;
+    try {
+      std::size_t numEdges{};
+      if (!writeRMat(path, scale, edgeFactor, parameters, seed, numThreads,
+                     numEdges)) {
+        return fmt::format("Falha ao gravar {}", path);
+      }
+      return fmt::format("{} arestas gravadas em {:.1f} s", numEdges,
+                         timer.elapsed());
+    } catch (std::bad_alloc const &) {
+      return fmt::format("Memória insuficiente para a escala {}", scale);
+    }
+  }};
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // Sem threads, a gravação roda no próximo onUpdate
+  m_exportResult = std::async(std::launch::deferred, task);
+#else
+  m_exportResult = std::async(std::launch::async, task);
+#endif
+  m_exportStatus = fmt::format("Gravando {}...", path);
+  updateAnimation();
+}
+
+void Window::createDefaultEdges(CounterRng &rng) {
+  // Tabela hash das arestas já inseridas: evita duplicatas em O(1) esperado
+  EdgeSet edgeSet;
 
   if (m_connectedGraph) {
     // Conectar cada nó ao próximo para garantir que o grafo seja conectado
+    auto const chainEdges{std::max(m_numNodes - 1, 0)};
+    m_edges.reserve(static_cast<std::size_t>(chainEdges + m_numNodes));
+    edgeSet.reserve(static_cast<std::size_t>(chainEdges + m_numNodes));
     for (int i = 0; i < m_numNodes - 1; ++i) {
-      m_edges.push_back({i, i + 1});
-    }
-
-    // Adicionar arestas aleatórias
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> nodeDis(0, m_numNodes - 1);
-
-    int extraEdges = m_numNodes; // Número de arestas extras
-    for (int i = 0; i < extraEdges; ++i) {
-      int a = nodeDis(gen);
-      int b = nodeDis(gen);
-      if (a != b) {
-        // Evitar arestas duplicadas
-        if (std::none_of(m_edges.begin(), m_edges.end(), [&](const Edge &e) {
-              return (e.nodeA == a && e.nodeB == b) ||
-                     (e.nodeA == b && e.nodeB == a);
-            })) {
-          m_edges.push_back({a, b});
-        }
-      }
+      addEdge(i, i + 1);
+      edgeSet.insert(i, i + 1);
     }
 
+    // Adicionar arestas aleatórias até atingir o total pedido, limitado a
+    // maxExpectedEdges
+    auto const firstExtra{m_edges.size()};
+    auto const totalEdges{std::min(
+        m_useTargetEdges ? static_cast<std::int64_t>(m_targetEdges)
+                         : std::int64_t{chainEdges} + m_numNodes,
+        maxExpectedEdges)};
+    sampleUniqueEdges(0, m_numNodes, totalEdges - chainEdges, chainEdges,
+                      edgeSet, m_edges, rng);
+    uniteEdges(firstExtra);
   } else {
-    // Dividir os nós em dois grupos
+    // Dividir os nós em dois grupos, sem arestas entre eles
     int splitIndex = m_numNodes / 2;
-
-    // Verificar se temos pelo menos dois nós em cada grupo
-    if (splitIndex == 0 || splitIndex == m_numNodes) {
-      // Não é possível dividir os nós em dois grupos, não adiciona arestas
-    } else {
-      // Adicionar arestas aleatórias dentro do primeiro grupo
-      std::random_device rd;
-      std::mt19937 gen(rd());
-      std::uniform_int_distribution<int> nodeDis1(0, splitIndex - 1);
-
-      int extraEdgesGroup1 =
-          splitIndex; // Número de arestas extras para o primeiro grupo
-      for (int i = 0; i < extraEdgesGroup1; ++i) {
-        int a = nodeDis1(gen);
-        int b = nodeDis1(gen);
-        if (a != b) {
-          // Evitar arestas duplicadas
-          if (std::none_of(m_edges.begin(), m_edges.end(), [&](const Edge &e) {
-                return (e.nodeA == a && e.nodeB == b) ||
-                       (e.nodeA == b && e.nodeB == a);
-              })) {
-            m_edges.push_back({a, b});
-          }
-        }
-      }
-
-      // Adicionar arestas aleatórias dentro do segundo grupo
-      std::uniform_int_distribution<int> nodeDis2(splitIndex, m_numNodes - 1);
-
-      int extraEdgesGroup2 =
-          m_numNodes -
-          splitIndex; // Número de arestas extras para o segundo grupo
-      for (int i = 0; i < extraEdgesGroup2; ++i) {
-        int a = nodeDis2(gen);
-        int b = nodeDis2(gen);
-        if (a != b) {
-          // Evitar arestas duplicadas
-          if (std::none_of(m_edges.begin(), m_edges.end(), [&](const Edge &e) {
-                return (e.nodeA == a && e.nodeB == b) ||
-                       (e.nodeA == b && e.nodeB == a);
-              })) {
-            m_edges.push_back({a, b});
-          }
-        }
-      }
+    auto const capacity1{maxEdgeCount(splitIndex)};
+    auto const capacity2{maxEdgeCount(m_numNodes - splitIndex)};
+
+    // Arestas por grupo: proporcionais à capacidade de cada grupo quando há
+    // um alvo, ou uma por nó do grupo caso contrário
+    std::int64_t edges1{splitIndex};
+    std::int64_t edges2{m_numNodes - splitIndex};
+    if (m_useTargetEdges && capacity1 + capacity2 > 0) {
+      auto const total{std::min<std::int64_t>(
+          {m_targetEdges, capacity1 + capacity2, maxExpectedEdges})};
+      edges1 = static_cast<std::int64_t>(static_cast<double>(total) *
+                                         static_cast<double>(capacity1) /
+                                         static_cast<double>(capacity1 +
+                                                             capacity2));
+      edges2 = std::min(total - edges1, capacity2);
+      edges1 = total - edges2;
     }
-  }
 
-  // Recalcular graus dos nós
-  computeNodeDegrees();
+    // Grupos com menos de dois nós não recebem arestas (capacidade nula)
+    sampleUniqueEdges(0, splitIndex, edges1, 0, edgeSet, m_edges, rng);
+    sampleUniqueEdges(splitIndex, m_numNodes, edges2, 0, edgeSet, m_edges,
+                      rng);
+    uniteEdges(0);
+  }
 }
 
 void Window::computeNodeDegrees() {
-  // Resetar graus
-  for (auto &node : m_nodes) {
-    node.degree = 0;
-  }
-
-  // Calcular graus com base nas arestas
-  for (const auto &edge : m_edges) {
-    m_nodes[edge.nodeA].degree++;
-    m_nodes[edge.nodeB].degree++;
+  // O grau de cada nó é o tamanho da sua vizinhança na estrutura CSR
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    m_nodes.degree[i] = m_graph.degree(static_cast<int>(i));
   }
 }
 
-bool Window::isGraphConnected() {
-  if (m_nodes.empty())
-    return true;
-
-  // Vetor para marcar nós visitados
-  std::vector<bool> visited(m_nodes.size(), false);
-
-  // Iniciar DFS a partir do primeiro nó
-  std::stack<int> stack;
-  stack.push(0);
-  visited[0] = true;
-
-  while (!stack.empty()) {
-    int current = stack.top();
-    stack.pop();
-
-    // Encontrar nós adjacentes
-    for (const auto &edge : m_edges) {
-      int neighbor = -1;
-      if (edge.nodeA == current) {
-        neighbor = edge.nodeB;
-      } else if (edge.nodeB == current) {
-        neighbor = edge.nodeA;
-      }
+void Window::addEdge(int nodeA, int nodeB) {
+  m_edges.push_back({nodeA, nodeB});
+  m_components.unite(nodeA, nodeB);
+}
 
-      if (neighbor != -1 && !visited[neighbor]) {
-        visited[neighbor] = true;
-        stack.push(neighbor);
-      }
-    }
+void Window::uniteEdges(std::size_t firstEdge) {
+  // Atualiza as componentes com as arestas acrescentadas por um gerador
+  for (auto i{firstEdge}; i < m_edges.size(); ++i) {
+    m_components.unite(m_edges[i].nodeA, m_edges[i].nodeB);
   }
-
-  // Verificar se todos os nós foram visitados
-  return std::all_of(visited.begin(), visited.end(), [](bool v) { return v; });
 }
 
 void Window::setupModel() {
-  // Criar modelo de círculo para os vértices
-  m_circleData.clear();
-
-  // Adicionar o centro do vértice
-  m_circleData.push_back(glm::vec2(0.0f, 0.0f)); // Center of the circle
-
-  // Gerar pontos de perímetro
-  const float step = glm::two_pi<float>() / static_cast<float>(m_circlePoints);
-  for (int i = 0; i <= m_circlePoints; ++i) {
-    float angle = i * step;
-    m_circleData.push_back(glm::vec2(std::cos(angle), std::sin(angle)));
-  }
+  // Modelo dos nós: quadrado [-1, 1]² desenhado como GL_TRIANGLE_STRIP. O
+  // círculo é avaliado analiticamente em node.frag
+  std::array const quad{glm::vec2{-1.0f, -1.0f}, glm::vec2{1.0f, -1.0f},
+                        glm::vec2{-1.0f, 1.0f}, glm::vec2{1.0f, 1.0f}};
 
   // Criar VBO e VAO para os nós
   glGenBuffers(1, &m_VBO_nodes);
@@ -583,31 +1211,58 @@ void Window::setupModel() {
   glBindVertexArray(m_VAO_nodes);
 
   glBindBuffer(GL_ARRAY_BUFFER, m_VBO_nodes);
-  glBufferData(GL_ARRAY_BUFFER, m_circleData.size() * sizeof(glm::vec2),
-               m_circleData.data(), GL_STATIC_DRAW);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad.data(), GL_STATIC_DRAW);
 
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
+  // Atributos por instância: avançam um registro a cada nó desenhado. As
+  // posições são enviadas por updateGeometry() e o raio e a cor por
+  // updateNodeInstances()
+  glGenBuffers(1, &m_VBO_positions);
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_positions);
+  glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+  glVertexAttribDivisor(1, 1);
+
+  glGenBuffers(1, &m_VBO_instances);
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_instances);
+  glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+
+  auto const stride{static_cast<GLsizei>(sizeof(NodeInstance))};
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(
+      2, 1, GL_FLOAT, GL_FALSE, stride,
+      reinterpret_cast<void *>(offsetof(NodeInstance, radius)));
+  glVertexAttribDivisor(2, 1);
+  glEnableVertexAttribArray(3);
+  glVertexAttribPointer(
+      3, 3, GL_FLOAT, GL_FALSE, stride,
+      reinterpret_cast<void *>(offsetof(NodeInstance, color)));
+  glVertexAttribDivisor(3, 1);
+
   // Desvincular
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
 
-  // Criar VBO e VAO para as arestas
-  glGenBuffers(1, &m_VBO_edges);
+  // Criar VAO e buffer de elementos para as arestas: os vértices são as
+  // próprias posições dos nós, e cada aresta é um par de índices
+  glGenBuffers(1, &m_EBO_edges);
   glGenVertexArrays(1, &m_VAO_edges);
 
   glBindVertexArray(m_VAO_edges);
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_edges);
-
-  // Atualizaremos os dados dinamicamente
-  glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO_positions);
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
-  // Desvincular
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  // Os índices são enviados por updateGeometry() quando o grafo muda
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_edges);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+
+  // Desvincular (o buffer de elementos permanece associado ao VAO)
   glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
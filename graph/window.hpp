@@ -4,47 +4,181 @@
 #define WINDOW_HPP_
 
 #include "abcgOpenGL.hpp"
+#include "csrgraph.hpp"
+#include "forcelayout.hpp"
+#include "generators.hpp"
+#include "glyphatlas.hpp"
+#include "parallel.hpp"
+#include "pivotmds.hpp"
+#include "unionfind.hpp"
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <array>
+#include <cstdint>
+#include <future>
+#include <string>
 #include <vector>
 
 class Window : public abcg::OpenGLWindow {
+public:
+  // Gera um novo grafo com a semente dada, com as configurações atuais (usado
+  // na renderização em lote sem janela)
+  void generateGraph(std::uint64_t seed);
+
 protected:
   void onCreate() override;
   void onPaint() override;
   void onPaintUI() override;
   void onResize(const glm::ivec2 &size) override;
+  void onUpdate() override;
   void onDestroy() override;
 
 private:
-  struct Node {
-    glm::vec2 position;
-    int degree{0};
-  };
-
-  struct Edge {
-    int nodeA;
-    int nodeB;
+  // Nós em estrutura de arrays (SoA): cada atributo em um vetor contíguo.
+  // As coordenadas vão diretamente para o layout de forças e os seus
+  // kernels SIMD, sem cópias intercaladas
+  struct NodeArrays {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<int> degree;
+
+    [[nodiscard]] std::size_t size() const { return x.size(); }
+    [[nodiscard]] bool empty() const { return x.empty(); }
+    [[nodiscard]] glm::vec2 position(std::size_t i) const {
+      return {x[i], y[i]};
+    }
+    void assign(std::size_t count) {
+      x.assign(count, 0.0f);
+      y.assign(count, 0.0f);
+      degree.assign(count, 0);
+    }
   };
 
-  std::vector<Node> m_nodes;
+  NodeArrays m_nodes;
   std::vector<Edge> m_edges;
+  CSRGraph m_graph; // Adjacência em CSR, reconstruída a cada novo grafo
+  UnionFind m_components; // Componentes conexas, atualizadas a cada aresta
   int m_numNodes{5};                       // Número padrão de nós
   float m_nodeRadius{0.05f};               // Raio padrão dos nós
   glm::vec3 m_nodeColor{1.0f, 0.0f, 0.0f}; // Cor padrão dos nós (vermelho)
+  bool m_nodeOutline{false};               // Desenha um anel na borda
+  glm::vec3 m_outlineColor{};              // Cor do anel (preto)
+  float m_outlineWidth{0.15f};             // Espessura, em fração do raio
   bool m_connectedGraph{true};             // Indica se o grafo é conectado
+  bool m_useTargetEdges{false}; // Gera exatamente m_targetEdges arestas
+  int m_targetEdges{10};        // Número alvo de arestas (para benchmarks)
+
+  // Semente de todos os geradores. Com m_fixedSeed desmarcado, cada novo grafo
+  // sorteia uma semente, que continua visível para reproduzir o grafo depois
+  std::uint64_t m_seed{};
+  bool m_fixedSeed{false};
+
+  // Modelo usado para gerar as arestas
+  enum class GraphModel {
+    Default,         // Caminho + arestas aleatórias, ou dois grupos desconexos
+    ErdosRenyiGnp,   // G(n, p) com saltos geométricos
+    ErdosRenyiGnm,   // G(n, m) com exatamente m_targetEdges arestas
+    StochasticBlock, // Blocos estocásticos (SBM)
+    BarabasiAlbert,  // Ligação preferencial (livre de escala)
+    RMat,            // R-MAT/Kronecker (Graph500), 2^escala nós
+  };
+  GraphModel m_graphModel{GraphModel::Default};
+  float m_edgeProbability{0.3f};      // p de G(n, p)
+  int m_numBlocks{2};                 // Número de blocos do SBM
+  float m_blockProbabilityIn{0.5f};   // p dentro de um mesmo bloco
+  float m_blockProbabilityOut{0.01f}; // p entre blocos distintos
+  int m_edgesPerNode{4};              // m do Barabási–Albert
+  int m_numThreads{defaultThreadCount()}; // Threads da geração paralela
+  int m_rmatScale{3};                 // log2 do número de nós do R-MAT
+  int m_rmatEdgeFactor{16};           // Sorteios de arestas por nó
+  RMatParameters m_rmatParameters;
+
+  // Posições iniciais dos nós, de onde parte o layout de forças
+  enum class InitialPlacement {
+    Random,   // Uniformes no quadrado
+    PivotMds, // Pivot-MDS das distâncias no grafo
+  };
+  InitialPlacement m_initialPlacement{InitialPlacement::Random};
+  // Estratégia que produziu as posições do grafo atual; o combo só vale a
+  // partir do próximo grafo
+  InitialPlacement m_nodesPlacement{InitialPlacement::Random};
+  // Cópia das posições iniciais: m_nodes passa a conter o layout, e
+  // reiniciar o layout parte destas
+  std::vector<float> m_initialX;
+  std::vector<float> m_initialY;
+  int m_numPivots{32}; // Pivôs do Pivot-MDS
+
+  // Geração de R-MAT direto para arquivo (testes de escala fora da UI)
+  int m_rmatFileScale{24};
+  std::array<char, 256> m_edgeFilePath{"rmat.bin"};
+  std::string m_exportStatus;
+  // Gravação em andamento, fora da thread da interface; o resultado é a
+  // mensagem de m_exportStatus
+  std::future<std::string> m_exportResult;
+
+  // Pôster em ladrilhos, exportado no início do próximo onPaint
+  glm::ivec2 m_posterSize{16384, 16384};
+  static constexpr int m_maxPosterSize{65536};
+  std::array<char, 256> m_posterPath{"poster.png"};
+  bool m_posterRequested{false};
+  std::string m_posterStatus;
+
+  // Layout de forças, avançado em onUpdate por até m_layoutBudget segundos
+  // por quadro enquanto m_runLayout estiver marcado
+  ForceLayout m_layout;
+  bool m_runLayout{false};
+  static constexpr double m_layoutBudget{0.008};
+
+  // Gravação dos quadros renderizados (índice de abcg::CaptureFormat)
+  int m_captureFormat{};
+  std::array<char, 256> m_capturePath{"graph.y4m"};
+
+  // Modo de grafos grandes: aceita até m_maxLargeNodes nós digitados, lista
+  // apenas as linhas visíveis da UI, omite rótulos e desenha os nós como
+  // pontos em uma única chamada de desenho
+  bool m_largeGraphMode{false};
+  static constexpr int m_maxSmallNodes{10};
+  static constexpr int m_maxLargeNodes{10'000'000};
+
+  // Estatísticas calculadas uma única vez por grafo gerado
+  float m_averageDegree{};
+  int m_maxDegree{};
+  double m_generationTime{}; // Em milissegundos
+
+  // Atributos por instância de cada nó, lidos por node.vert com divisor 1.
+  // A posição fica em um buffer próprio, compartilhado com as arestas
+  struct NodeInstance {
+    float radius;
+    glm::vec3 color;
+  };
+
+  // Posições e índices das arestas só são reenviados à GPU quando o grafo
+  // muda; raio e cor também quando mudam na interface. O layout de forças
+  // reenvia apenas as posições
+  bool m_geometryDirty{true};
+  bool m_positionsDirty{true};
+  bool m_instancesDirty{true};
+  GLsizei m_edgeIndexCount{};
+  GLenum m_edgeIndexType{GL_UNSIGNED_SHORT};
 
   GLuint m_program{};
-  GLint m_colorLoc{};
-  GLint m_translationLoc{};
-  GLint m_scaleLoc{};
   GLint m_projMatrixLoc{};
+  GLint m_pixelsPerUnitLoc{};
+  GLint m_outlineColorLoc{};
+  GLint m_outlineWidthLoc{};
+
+  GLuint m_edgeProgram{};
+  GLint m_edgeProjMatrixLoc{};
+  GLint m_edgeColorLoc{};
 
   GLuint m_VAO_nodes{};
   GLuint m_VBO_nodes{};
+  GLuint m_VBO_positions{};
+  GLuint m_VBO_instances{};
   GLuint m_VAO_edges{};
-  GLuint m_VBO_edges{};
+  GLuint m_EBO_edges{};
 
   GLuint m_fontTexture{};
   GLint m_fontTextureLoc{};
@@ -54,29 +188,58 @@ private:
 
   GLuint m_VAO_text{};
   GLuint m_VBO_text{};
+  GLuint m_VBO_textCorners{};
+
+  // Atlas SDF dos glifos da fonte embutida
+  GlyphAtlas m_glyphAtlas;
 
-  struct Character {
-    glm::vec2 texCoords[4]; // Texture coordinates for the quad
-    float advance;          // How much to move after rendering this character
+  // Glifo de um rótulo, relativo à posição do nó
+  struct LabelGlyph {
+    glm::vec2 offset;  // Canto inferior esquerdo
+    glm::vec2 size;    // Largura e altura
+    glm::vec4 texRect; // Coordenadas de textura (u0, v0, u1, v1)
   };
 
-  // Map digits to Character data
-  std::array<Character, 10> m_characters;
+  // Atributos por instância de text.vert: um registro por glifo desenhado
+  struct GlyphInstance {
+    glm::vec2 anchor;
+    glm::vec2 offset;
+    glm::vec2 size;
+    glm::vec4 texRect;
+  };
 
-  glm::ivec2 m_viewportSize{};
+  // Glifos do rótulo de cada nó, montados uma vez por índice de nó: o rótulo
+  // do nó i ocupa m_labelGlyphs[m_labelRunStart[i], m_labelRunStart[i + 1])
+  std::vector<LabelGlyph> m_labelGlyphs;
+  std::vector<std::size_t> m_labelRunStart;
+  bool m_labelsDirty{true};
+  GLsizei m_labelGlyphCount{};
 
-  int m_circlePoints{100};
+  glm::ivec2 m_viewportSize{};
 
-  std::vector<glm::vec2> m_circleData;
   glm::mat4 m_projMatrix{};
 
+  void generateGraph();
   void createNodes();
   void createEdges();
+  void placeNodes();
+  void createDefaultEdges(CounterRng &rng);
+  void exportRMat();
+  void exportPoster();
+  void paintGraph(float pixelsPerUnit);
+  void updateGeometry();
+  void updatePositions();
+  void resetLayout();
+  void updateAnimation();
+  void applyLayout();
+  void fitPositions(std::span<float const> x, std::span<float const> y);
+  void updateNodeInstances();
   void computeNodeDegrees();
-  bool isGraphConnected(); // Função para verificar conectividade
+  void addEdge(int nodeA, int nodeB);
+  void uniteEdges(std::size_t firstEdge);
   void setupModel();
-  void renderText(std::string text, glm::vec2 position);
-  void initCharacters();
+  void cacheLabelRuns(std::size_t count);
+  void updateLabels();
   void setupTextRendering();
 };
 